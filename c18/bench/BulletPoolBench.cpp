@@ -0,0 +1,376 @@
+// The passes over the live bullets of a BulletPool with the Morton reorder
+// on and off: the update and the churn of the bullets, the reorder, and a
+// query of the near bullets through a sweep hash like the interception.
+// In ms a frame and, where the counters of the CPU are allowed, in cache
+// misses a frame.
+// bullet_pool_bench [bullets] [frames]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+#include "Ai/BulletPool.h"
+#include "Bullet.h"
+#include "Platform.h"
+#include "Platform/Headless.h"
+#include "Segment.h"
+#include "SweepHash.h"
+#include "TheTime.h"
+#include "WeaponProfile.h"
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using Ai::BulletPool;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const int DefaultBullets    = 10000;
+const int DefaultFrames     = 600; // 10 s at 60 fps
+const unsigned MaxAgeMs     = 5000;
+const int WarmUpFrames      = 300; // till the pool is full, a max age
+const int ReorderFrames     = 30; // as TheArmoury
+const double ArenaSize      = 100.0; // [m], across
+const double ArenaHeight    = 20.0; // [m]
+const double NearDistance   = 1.0; // [m], a pair of the query
+const double SweepCellSize  = 2.0; // [m], as TheArmoury
+const int SweepBucketBits   = 14;
+
+// the same bullets in both runs, they are fired and released by the ages
+class Random
+{
+private:
+    unsigned state_;
+
+public:
+    explicit Random(unsigned seed) : state_(seed) {}
+
+    double next(double min, double max)
+    {
+        state_ = state_ * 1664525u + 1013904223u;
+        return min + (max - min) * ((state_ >> 8) / 16777216.0);
+    }
+};
+
+// 0 where the kernel does not let the process count
+class MissCounter
+{
+private:
+    int fd_;
+
+public:
+    MissCounter() : fd_(-1)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        const long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        fd_ = static_cast< int >(fd);
+#endif
+    }
+
+    ~MissCounter()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+#endif
+    }
+
+    bool is_available() const { return fd_ >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop()
+    {
+        long long count = 0;
+#ifdef __linux__
+        if (fd_ >= 0)
+        {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+
+            if (read(fd_, &count, sizeof(count)) != sizeof(count))
+            {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    MissCounter(const MissCounter&);
+    MissCounter& operator=(const MissCounter&);
+};
+
+class Stage
+{
+public:
+    double ms;
+    long long misses;
+
+public:
+    Stage() : ms(0.0), misses(0) {}
+};
+
+class Result
+{
+public:
+    Stage update;
+    Stage reorder;
+    Stage query;
+    long long pairs; // found by the queries, the same in both runs
+
+public:
+    Result() : update(), reorder(), query(), pairs(0) {}
+};
+
+class Clock
+{
+private:
+    std::chrono::steady_clock::time_point begin_;
+    MissCounter* counter_;
+
+public:
+    explicit Clock(MissCounter* counter)
+    :   begin_(std::chrono::steady_clock::now()), counter_(counter)
+    {
+        counter_->start();
+    }
+
+    void stop(Stage* stage)
+    {
+        using namespace std::chrono;
+        stage->misses = stage->misses + counter_->stop();
+        const steady_clock::duration time = steady_clock::now() - begin_;
+        const double ns = duration_cast< nanoseconds >(time).count();
+        stage->ms = stage->ms + ns / 1e6;
+    }
+};
+
+void fire(  BulletPool* pool,
+            const WeaponProfile& profile,
+            Random* random)
+{
+    int handle = 0;
+    Bullet* bullet = pool->append(&handle);
+
+    if (!bullet)
+    {
+        return;
+    }
+
+    const Vector3 from( random->next(0.0, ArenaSize),
+                        random->next(0.0, ArenaHeight),
+                        random->next(0.0, ArenaSize));
+    const Vector3 angle(random->next(-10.0, 10.0),
+                        random->next(-180.0, 180.0),
+                        0.0);
+    bullet->initialize(0, handle, profile, from, angle, 0, 0);
+}
+
+// the pairs of the bullets nearer than NearDistance in the frame
+long long query(const BulletPool& pool, SweepHash* hash)
+{
+    hash->clear();
+
+    for (int i = 0; i < pool.size(); ++i)
+    {
+        const Segment locus = pool.at(i)->locus_segment();
+        hash->add(i, locus.from, locus.to);
+    }
+
+    hash->build();
+
+    std::vector< int > found;
+    long long pairs = 0;
+
+    for (int i = 0; i < pool.size(); ++i)
+    {
+        const Vector3* point = pool.at(i)->point();
+        Vector3 min(point->x - NearDistance,
+                    point->y - NearDistance,
+                    point->z - NearDistance);
+        Vector3 max(point->x + NearDistance,
+                    point->y + NearDistance,
+                    point->z + NearDistance);
+        found.clear();
+        hash->find(min, max, &found);
+
+        for (size_t j = 0; j < found.size(); ++j)
+        {
+            if (found.at(j) <= i)
+            {
+                continue;
+            }
+
+            Vector3 to(*pool.at(found.at(j))->point());
+            to.subtract(*point);
+
+            if (to.squared_length() < NearDistance * NearDistance)
+            {
+                ++pairs;
+            }
+        }
+    }
+
+    return pairs;
+}
+
+// as TheArmoury::update_pool, the last one is moved to the slot
+void update(BulletPool* pool)
+{
+    int i = 0;
+
+    while (i < pool->size())
+    {
+        Bullet* bullet = pool->at(i);
+        bullet->update< WeaponProfile::KindBallistic >();
+
+        if (bullet->is_owned())
+        {
+            ++i;
+            continue;
+        }
+
+        pool->release(i);
+    }
+}
+
+Result run(int bullets, int frames, bool does_reorder, MissCounter* counter)
+{
+    Platform::Headless::create(1, 1, 1);
+    TheTime::create();
+
+    WeaponProfile profile;
+    profile.id = "bench";
+    profile.kind = WeaponProfile::KindBallistic;
+    profile.speed0 = 20.0;
+    profile.speed_max = 20.0;
+    profile.max_age_ms = MaxAgeMs;
+
+    // a little more than the ones which age out, so the pool stays full
+    const int fired_per_frame = bullets / WarmUpFrames + 1;
+
+    BulletPool pool(bullets);
+    SweepHash hash(SweepCellSize, SweepBucketBits);
+    Random random(12345);
+    Result result;
+    Result warm_up;
+
+    for (int frame = 0; frame < WarmUpFrames + frames; ++frame)
+    {
+        Result* stages = frame < WarmUpFrames ? &warm_up : &result;
+        TheTime::instance().tick();
+
+        {
+            Clock clock(counter);
+            update(&pool);
+
+            for (int i = 0; i < fired_per_frame; ++i)
+            {
+                fire(&pool, profile, &random);
+            }
+
+            clock.stop(&stages->update);
+        }
+
+        if (does_reorder && frame % ReorderFrames == 0)
+        {
+            Clock clock(counter);
+            pool.reorder();
+            clock.stop(&stages->reorder);
+        }
+
+        {
+            Clock clock(counter);
+            const long long pairs = query(pool, &hash);
+            clock.stop(&stages->query);
+            stages->pairs = stages->pairs + pairs;
+        }
+
+        Platform::end_frame();
+    }
+
+    TheTime::destroy();
+    Platform::Headless::destroy();
+    return result;
+}
+
+void report(const char* name, const Stage& stage, int frames, bool has_misses)
+{
+    if (has_misses)
+    {
+        std::printf(    "  %-8s %8.3f ms %12.0f misses\n",
+                        name,
+                        stage.ms / frames,
+                        static_cast< double >(stage.misses) / frames);
+    }
+    else
+    {
+        std::printf("  %-8s %8.3f ms\n", name, stage.ms / frames);
+    }
+}
+
+void report(const char* name, const Result& result, int frames, bool has_misses)
+{
+    std::printf("%s, %lld pairs\n", name, result.pairs);
+    report("update", result.update, frames, has_misses);
+    report("reorder", result.reorder, frames, has_misses);
+    report("query", result.query, frames, has_misses);
+}
+
+} // namespace -
+
+int main(int argc, char** argv)
+{
+    const int bullets = argc > 1 ? std::atoi(argv[1]) : DefaultBullets;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : DefaultFrames;
+
+    if (bullets <= 0 || frames <= 0)
+    {
+        std::fprintf(stderr, "usage: bullet_pool_bench [bullets] [frames]\n");
+        return 1;
+    }
+
+    MissCounter counter;
+    std::printf(    "%d bullets, %d frames after %d to fill the pool, "
+                    "a frame:\n",
+                    bullets,
+                    frames,
+                    WarmUpFrames);
+
+    if (!counter.is_available())
+    {
+        std::printf("the cache misses are not counted here\n");
+    }
+
+    const Result off = run(bullets, frames, false, &counter);
+    const Result on = run(bullets, frames, true, &counter);
+    report("DoesReorder false", off, frames, counter.is_available());
+    report("DoesReorder true", on, frames, counter.is_available());
+    return 0;
+}
@@ -0,0 +1,236 @@
+// The throughput of FastMath against the standard library, the scalar
+// calls and the 4 and 8 lane ones, in nanoseconds a result.
+// fast_math_bench [results]
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "FastMath.h"
+
+namespace
+{
+
+const double Pi         = 3.14159265358979323846;
+const double RadPerDeg  = Pi / 180.0;
+const double DegPerRad  = 180.0 / Pi;
+const int DefaultSize   = 1 << 20; // a multiple of 8
+const int Repeats       = 8;
+
+double g_sink = 0.0; // keeps the results alive
+
+class Inputs
+{
+public:
+    std::vector< double > degrees;
+    std::vector< double > ys;
+    std::vector< double > xs;
+
+public:
+    explicit Inputs(int size) : degrees(size), ys(size), xs(size)
+    {
+        unsigned seed = 12345;
+
+        for (int i = 0; i < size; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            degrees[i] = (seed >> 8) / 16777216.0 * 1440.0 - 720.0;
+            seed = seed * 1664525u + 1013904223u;
+            ys[i] = (seed >> 8) / 16777216.0 * 200.0 - 100.0;
+            seed = seed * 1664525u + 1013904223u;
+            xs[i] = (seed >> 8) / 16777216.0 * 200.0 - 100.0;
+        }
+    }
+};
+
+double libm_sin(double degree) { return std::sin(degree * RadPerDeg); }
+
+double libm_cos(double degree) { return std::cos(degree * RadPerDeg); }
+
+double libm_atan2(double y, double x) { return std::atan2(y, x) * DegPerRad; }
+
+// the best of the repeats, the others are taken by the caches and the clock
+template< class Body >
+double time_ns(const Body& body, int size)
+{
+    using namespace std::chrono;
+    double best = 0.0;
+
+    for (int i = 0; i < Repeats; ++i)
+    {
+        const steady_clock::time_point begin = steady_clock::now();
+        body();
+        const steady_clock::duration time = steady_clock::now() - begin;
+        const double ns = duration_cast< nanoseconds >(time).count();
+        best = i == 0 || ns < best ? ns : best;
+    }
+
+    return best / size;
+}
+
+template< double (*F)(double) >
+class Scalar
+{
+private:
+    const std::vector< double >& in_;
+    std::vector< double >* out_;
+
+public:
+    Scalar(const std::vector< double >& in, std::vector< double >* out)
+    :   in_(in), out_(out)
+    {}
+
+    void operator()() const
+    {
+        for (size_t i = 0; i < in_.size(); ++i)
+        {
+            (*out_)[i] = F(in_[i]);
+        }
+
+        g_sink = g_sink + (*out_)[in_.size() / 2];
+    }
+};
+
+template< void (*F)(const double*, double*), int LaneSize >
+class Lanes
+{
+private:
+    const std::vector< double >& in_;
+    std::vector< double >* out_;
+
+public:
+    Lanes(const std::vector< double >& in, std::vector< double >* out)
+    :   in_(in), out_(out)
+    {}
+
+    void operator()() const
+    {
+        for (size_t i = 0; i < in_.size(); i = i + LaneSize)
+        {
+            F(&in_[i], &(*out_)[i]);
+        }
+
+        g_sink = g_sink + (*out_)[in_.size() / 2];
+    }
+};
+
+template< double (*F)(double, double) >
+class Scalar2
+{
+private:
+    const std::vector< double >& ys_;
+    const std::vector< double >& xs_;
+    std::vector< double >* out_;
+
+public:
+    Scalar2(    const std::vector< double >& ys,
+                const std::vector< double >& xs,
+                std::vector< double >* out)
+    :   ys_(ys), xs_(xs), out_(out)
+    {}
+
+    void operator()() const
+    {
+        for (size_t i = 0; i < ys_.size(); ++i)
+        {
+            (*out_)[i] = F(ys_[i], xs_[i]);
+        }
+
+        g_sink = g_sink + (*out_)[ys_.size() / 2];
+    }
+};
+
+template< void (*F)(const double*, const double*, double*), int LaneSize >
+class Lanes2
+{
+private:
+    const std::vector< double >& ys_;
+    const std::vector< double >& xs_;
+    std::vector< double >* out_;
+
+public:
+    Lanes2( const std::vector< double >& ys,
+            const std::vector< double >& xs,
+            std::vector< double >* out)
+    :   ys_(ys), xs_(xs), out_(out)
+    {}
+
+    void operator()() const
+    {
+        for (size_t i = 0; i < ys_.size(); i = i + LaneSize)
+        {
+            F(&ys_[i], &xs_[i], &(*out_)[i]);
+        }
+
+        g_sink = g_sink + (*out_)[ys_.size() / 2];
+    }
+};
+
+void report(const char* name, double libm_ns, double ns)
+{
+    std::printf(    "%-18s %7.2f ns  x%.2f\n",
+                    name,
+                    ns,
+                    ns > 0.0 ? libm_ns / ns : 0.0);
+}
+
+} // namespace -
+
+int main(int argc, char** argv)
+{
+    const int size = argc > 1 ? std::atoi(argv[1]) / 8 * 8 : DefaultSize;
+
+    if (size <= 0)
+    {
+        std::fprintf(stderr, "usage: fast_math_bench [results]\n");
+        return 1;
+    }
+
+    const Inputs in(size);
+    std::vector< double > out(size);
+
+    std::printf("%d results, the best of %d runs, x the speed of libm\n",
+                size,
+                Repeats);
+
+    const double libm_sin_ns
+    = time_ns(Scalar< libm_sin >(in.degrees, &out), size);
+    report("libm sin", libm_sin_ns, libm_sin_ns);
+    report( "FastMath::sin",
+            libm_sin_ns,
+            time_ns(Scalar< FastMath::sin >(in.degrees, &out), size));
+    report( "FastMath::sin4",
+            libm_sin_ns,
+            time_ns(Lanes< FastMath::sin4, 4 >(in.degrees, &out), size));
+    report( "FastMath::sin8",
+            libm_sin_ns,
+            time_ns(Lanes< FastMath::sin8, 8 >(in.degrees, &out), size));
+
+    const double libm_cos_ns
+    = time_ns(Scalar< libm_cos >(in.degrees, &out), size);
+    report("libm cos", libm_cos_ns, libm_cos_ns);
+    report( "FastMath::cos",
+            libm_cos_ns,
+            time_ns(Scalar< FastMath::cos >(in.degrees, &out), size));
+    report( "FastMath::cos4",
+            libm_cos_ns,
+            time_ns(Lanes< FastMath::cos4, 4 >(in.degrees, &out), size));
+    report( "FastMath::cos8",
+            libm_cos_ns,
+            time_ns(Lanes< FastMath::cos8, 8 >(in.degrees, &out), size));
+
+    const double libm_atan2_ns
+    = time_ns(Scalar2< libm_atan2 >(in.ys, in.xs, &out), size);
+    report("libm atan2", libm_atan2_ns, libm_atan2_ns);
+    report( "FastMath::atan2",
+            libm_atan2_ns,
+            time_ns(Scalar2< FastMath::atan2 >(in.ys, in.xs, &out), size));
+    report( "FastMath::atan2_4",
+            libm_atan2_ns,
+            time_ns(Lanes2< FastMath::atan2_4, 4 >(in.ys, in.xs, &out), size));
+    report( "FastMath::atan2_8",
+            libm_atan2_ns,
+            time_ns(Lanes2< FastMath::atan2_8, 8 >(in.ys, in.xs, &out), size));
+
+    return g_sink == 12345.0 ? 2 : 0; // never, but the sink is read
+}
@@ -0,0 +1,174 @@
+// The fill rate of the Rasterizer by the count of the threads: layers of
+// a grid of small textured quads over the whole frame, blended and tested
+// against the depth, so each layer fills each pixel once.  The set up and
+// the binning are on the thread of the caller, the fill on all of them.
+// rasterizer_bench [c18 dir] [layers] [frames]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Image.h"
+#include "Rasterizer.h"
+
+namespace
+{
+
+const int Width         = 1280;
+const int Height        = 720;
+const int CellSize      = 16; // [pixel], divides the width and the height
+const int DefaultLayers = 8;
+const int DefaultFrames = 60;
+
+class Result
+{
+public:
+    double add_ms;
+    double flush_ms;
+
+public:
+    Result() : add_ms(0.0), flush_ms(0.0) {}
+};
+
+double get_ms(const std::chrono::steady_clock::time_point& begin)
+{
+    using namespace std::chrono;
+    const steady_clock::duration time = steady_clock::now() - begin;
+    return duration_cast< nanoseconds >(time).count() / 1e6;
+}
+
+// the corner of a cell in the clip space, the nearer layers are drawn last
+void set_corner(int column, int row, int layer, int layers, double* p)
+{
+    p[0] = 2.0 * column * CellSize / Width - 1.0;
+    p[1] = 1.0 - 2.0 * row * CellSize / Height;
+    p[2] = 1.0 - (layer + 1.0) / (layers + 1.0);
+    p[3] = 1.0;
+}
+
+void add_layer(Rasterizer* rasterizer, int layer, int layers)
+{
+    const unsigned color = 0x80ffffff - 0x00102030 * (layer % 4);
+
+    for (int row = 0; row < Height / CellSize; ++row)
+    {
+        for (int column = 0; column < Width / CellSize; ++column)
+        {
+            double p[4][4];
+            set_corner(column, row, layer, layers, p[0]);
+            set_corner(column + 1, row, layer, layers, p[1]);
+            set_corner(column + 1, row + 1, layer, layers, p[2]);
+            set_corner(column, row + 1, layer, layers, p[3]);
+            const double t[4][2] =
+            {
+                { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, 1.0 }, { 0.0, 1.0 }
+            };
+            rasterizer->add_triangle(   p[0], p[1], p[2],
+                                        t[0], t[1], t[2],
+                                        color, color, color);
+            rasterizer->add_triangle(   p[0], p[2], p[3],
+                                        t[0], t[2], t[3],
+                                        color, color, color);
+        }
+    }
+}
+
+Result run(const Image& texture, int thread_count, int layers, int frames)
+{
+    Rasterizer rasterizer(Width, Height, thread_count);
+    rasterizer.blend_mode(Rasterizer::BlendLinear);
+    rasterizer.enable_depth_write(false);
+    rasterizer.texture(&texture);
+    Result result;
+
+    // one frame to warm the caches and the allocations up
+    for (int frame = -1; frame < frames; ++frame)
+    {
+        const std::chrono::steady_clock::time_point begin
+        = std::chrono::steady_clock::now();
+        rasterizer.clear(0xff000000);
+
+        for (int layer = 0; layer < layers; ++layer)
+        {
+            add_layer(&rasterizer, layer, layers);
+        }
+
+        const double add_ms = get_ms(begin);
+        rasterizer.flush();
+        const double ms = get_ms(begin);
+
+        if (frame >= 0)
+        {
+            result.add_ms = result.add_ms + add_ms;
+            result.flush_ms = result.flush_ms + ms - add_ms;
+        }
+    }
+
+    return result;
+}
+
+} // namespace -
+
+int main(int argc, char** argv)
+{
+    const std::string directory = argc > 1 ? argv[1] : ".";
+    const int layers = argc > 2 ? std::atoi(argv[2]) : DefaultLayers;
+    const int frames = argc > 3 ? std::atoi(argv[3]) : DefaultFrames;
+    Image texture;
+
+    if (layers <= 0 || frames <= 0)
+    {
+        std::fprintf(   stderr,
+                        "usage: rasterizer_bench [c18 dir] [layers] "
+                        "[frames]\n");
+        return 1;
+    }
+
+    if (!Image::load(directory + "/data/image/grid.tga", &texture))
+    {
+        std::fprintf(   stderr,
+                        "cannot load %s/data/image/grid.tga\n",
+                        directory.c_str());
+        return 1;
+    }
+
+    const int hardware_threads
+    = std::max(static_cast< int >(std::thread::hardware_concurrency()), 1);
+    std::vector< int > thread_counts;
+
+    for (int count = 1; count < hardware_threads; count = count * 2)
+    {
+        thread_counts.push_back(count);
+    }
+
+    thread_counts.push_back(hardware_threads);
+
+    const int triangles = layers * (Width / CellSize) * (Height / CellSize) * 2;
+    const double pixels = static_cast< double >(Width) * Height * layers;
+    std::printf(    "%dx%d, %d layers of %d triangles, %d frames, a frame:\n",
+                    Width,
+                    Height,
+                    layers,
+                    triangles / layers,
+                    frames);
+    double one_thread_ms = 0.0;
+
+    for (size_t i = 0; i < thread_counts.size(); ++i)
+    {
+        const Result result = run(texture, thread_counts[i], layers, frames);
+        const double add_ms = result.add_ms / frames;
+        const double flush_ms = result.flush_ms / frames;
+        one_thread_ms = i == 0 ? flush_ms : one_thread_ms;
+        std::printf(    "%2d threads: add %7.3f ms, flush %7.3f ms, "
+                        "%7.1f Mpixels/s, x%.2f\n",
+                        thread_counts[i],
+                        add_ms,
+                        flush_ms,
+                        pixels / flush_ms / 1e3,
+                        one_thread_ms / flush_ms);
+    }
+
+    return 0;
+}
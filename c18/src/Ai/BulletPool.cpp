@@ -0,0 +1,220 @@
+#include "Ai/BulletPool.h"
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+#include "Bullet.h"
+
+using GraphicsDatabase::Vector3;
+
+namespace Ai
+{
+
+namespace
+{
+
+const int MortonBits = 10; // a axis, 30 bits in all
+const unsigned MortonCells = 1u << MortonBits;
+
+// 0000 0000 0000 0000 0000 00ab cdef ghij -> 0000 a00b 00c0 0d00 ... 00j
+unsigned spread_bits(unsigned a)
+{
+    a = a & 0x000003ff;
+    a = (a ^ (a << 16)) & 0xff0000ff;
+    a = (a ^ (a << 8)) & 0x0300f00f;
+    a = (a ^ (a << 4)) & 0x030c30c3;
+    a = (a ^ (a << 2)) & 0x09249249;
+    return a;
+}
+
+unsigned to_cell(double a, double min, double scale)
+{
+    const double cell = (a - min) * scale;
+
+    if (cell <= 0.0)
+    {
+        return 0;
+    }
+    else if (cell >= static_cast< double >(MortonCells - 1))
+    {
+        return MortonCells - 1;
+    }
+
+    return static_cast< unsigned >(cell);
+}
+
+} // namespace -
+
+BulletPool::BulletPool(int capacity)
+:   capacity_(capacity),
+    size_(0),
+    bullets_(0),
+    scratch_(0),
+    handle_of_slot_(0),
+    slot_of_handle_(0),
+    free_handles_(),
+    keys_()
+{
+    assert(capacity_ > 0);
+    bullets_ = new Bullet[capacity_];
+    scratch_ = new Bullet[capacity_];
+    handle_of_slot_ = new int[capacity_];
+    slot_of_handle_ = new int[capacity_];
+    free_handles_.reserve(capacity_);
+    keys_.reserve(capacity_);
+
+    // popped from the back, so the first bullet takes the handle 0
+    for (int i = capacity_ - 1; i >= 0; --i)
+    {
+        slot_of_handle_[i] = -1;
+        free_handles_.push_back(i);
+    }
+}
+
+BulletPool::~BulletPool()
+{
+    delete[] bullets_;
+    bullets_ = 0;
+    delete[] scratch_;
+    scratch_ = 0;
+    delete[] handle_of_slot_;
+    handle_of_slot_ = 0;
+    delete[] slot_of_handle_;
+    slot_of_handle_ = 0;
+}
+
+// returns 0 when full
+Bullet* BulletPool::append(int* handle)
+{
+    if (size_ == capacity_)
+    {
+        return 0;
+    }
+
+    const int new_handle = free_handles_.back();
+    free_handles_.pop_back();
+
+    handle_of_slot_[size_] = new_handle;
+    slot_of_handle_[new_handle] = size_;
+    size_ = size_ + 1;
+
+    if (handle)
+    {
+        *handle = new_handle;
+    }
+
+    return &bullets_[size_ - 1];
+}
+
+Bullet* BulletPool::at(int slot)
+{
+    assert(slot >= 0 && slot < size_);
+    return &bullets_[slot];
+}
+
+const Bullet* BulletPool::at(int slot) const
+{
+    assert(slot >= 0 && slot < size_);
+    return &bullets_[slot];
+}
+
+// returns 0 when the bullet of the handle has been released
+Bullet* BulletPool::find(int handle)
+{
+    assert(handle >= 0 && handle < capacity_);
+    const int slot = slot_of_handle_[handle];
+    return slot < 0 ? 0 : &bullets_[slot];
+}
+
+int BulletPool::handle(int slot) const
+{
+    assert(slot >= 0 && slot < size_);
+    return handle_of_slot_[slot];
+}
+
+// fills the hole by the last bullet
+void BulletPool::release(int slot)
+{
+    assert(slot >= 0 && slot < size_);
+    const int last = size_ - 1;
+    const int released = handle_of_slot_[slot];
+
+    slot_of_handle_[released] = -1;
+    free_handles_.push_back(released);
+
+    if (slot != last)
+    {
+        bullets_[slot] = bullets_[last];
+        handle_of_slot_[slot] = handle_of_slot_[last];
+        slot_of_handle_[handle_of_slot_[slot]] = slot;
+    }
+
+    size_ = last;
+}
+
+// Sorts the live bullets by the Z-order of their points in the bounding box
+// of them, so the bullets near in the space are near in the memory.
+void BulletPool::reorder()
+{
+    if (size_ < 2)
+    {
+        return;
+    }
+
+    Vector3 min(*bullets_[0].point());
+    Vector3 max(min);
+
+    for (int i = 1; i < size_; ++i)
+    {
+        const Vector3* point = bullets_[i].point();
+        min.set(    std::min(min.x, point->x),
+                    std::min(min.y, point->y),
+                    std::min(min.z, point->z));
+        max.set(    std::max(max.x, point->x),
+                    std::max(max.y, point->y),
+                    std::max(max.z, point->z));
+    }
+
+    const double extent
+    = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+    const double scale
+    = extent > 0.0 ? static_cast< double >(MortonCells) / extent : 0.0;
+
+    keys_.clear();
+
+    for (int i = 0; i < size_; ++i)
+    {
+        const Vector3* point = bullets_[i].point();
+        const unsigned key
+        = spread_bits(to_cell(point->x, min.x, scale))
+        | spread_bits(to_cell(point->y, min.y, scale)) << 1
+        | spread_bits(to_cell(point->z, min.z, scale)) << 2;
+        keys_.push_back(std::make_pair(key, i));
+    }
+
+    std::sort(keys_.begin(), keys_.end());
+
+    for (int i = 0; i < size_; ++i)
+    {
+        scratch_[i] = bullets_[keys_.at(i).second];
+    }
+
+    std::swap(bullets_, scratch_);
+
+    // the keys are done, so they keep the handles in the new order
+    for (int i = 0; i < size_; ++i)
+    {
+        keys_.at(i).second = handle_of_slot_[keys_.at(i).second];
+    }
+
+    for (int i = 0; i < size_; ++i)
+    {
+        handle_of_slot_[i] = keys_.at(i).second;
+        slot_of_handle_[handle_of_slot_[i]] = i;
+    }
+}
+
+int BulletPool::size() const { return size_; }
+
+} // namespace Ai
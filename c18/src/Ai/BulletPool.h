@@ -0,0 +1,45 @@
+#ifndef ROBOF__AI__BULLET_POOL_H_
+#define ROBOF__AI__BULLET_POOL_H_
+#include <utility>
+#include <vector>
+
+class Bullet;
+
+namespace Ai
+{
+
+// The live bullets are packed in [0, size()), so the passes over them stream
+// through the memory.  The slots move when the others are released or
+// reordered, the handles stay until the bullet itself is released.
+class BulletPool
+{
+private:
+    int capacity_;
+    int size_;
+    Bullet* bullets_;
+    Bullet* scratch_;
+    int* handle_of_slot_;
+    int* slot_of_handle_;
+    std::vector< int > free_handles_;
+    std::vector< std::pair< unsigned, int > > keys_;
+
+public:
+    BulletPool(int capacity);
+    ~BulletPool();
+    Bullet* append(int* handle);
+    Bullet* at(int slot);
+    const Bullet* at(int slot) const;
+    Bullet* find(int handle);
+    int handle(int slot) const;
+    void release(int slot);
+    void reorder();
+    int size() const;
+
+private:
+    BulletPool(const BulletPool&);
+    BulletPool& operator=(const BulletPool&);
+};
+
+} // namespace Ai
+
+#endif
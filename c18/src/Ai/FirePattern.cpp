@@ -0,0 +1,108 @@
+#include "Ai/FirePattern.h"
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+namespace Ai
+{
+
+FirePattern::FirePattern()
+:   shape(ShapeSingle),
+    rounds(1),
+    spread(0.0),
+    spacing(0.0),
+    jitter(0.0),
+    seed(0)
+{}
+
+FirePattern::FirePattern(   Shape pattern_shape,
+                            int pattern_rounds,
+                            double pattern_spread,
+                            double pattern_spacing,
+                            double pattern_jitter,
+                            unsigned pattern_seed)
+:   shape(pattern_shape),
+    rounds(pattern_rounds),
+    spread(pattern_spread),
+    spacing(pattern_spacing),
+    jitter(pattern_jitter),
+    seed(pattern_seed)
+{}
+
+FirePattern::~FirePattern() {}
+
+namespace
+{
+
+// a hash, not a sequence, so any round can be made in any order
+unsigned hash(unsigned a)
+{
+    a = (a ^ 61) ^ (a >> 16);
+    a = a + (a << 3);
+    a = a ^ (a >> 4);
+    a = a * 0x27d4eb2d;
+    a = a ^ (a >> 15);
+    return a;
+}
+
+// [-1, 1]
+double get_noise(unsigned key)
+{
+    return static_cast< double >(hash(key) & 0xffff) / 32767.5 - 1.0;
+}
+
+} // namespace -
+
+// trigger counts the pulls, so that every pull gets another jitter
+void FirePattern::get_round(    int index,
+                                unsigned trigger,
+                                const Vector3& from,
+                                const Vector3& angle,
+                                Vector3* round_from,
+                                Vector3* round_angle) const
+{
+    *round_from = from;
+    *round_angle = angle;
+
+    switch (shape)
+    {
+        case ShapeSingle:
+            break;
+
+        case ShapeFan:
+            if (rounds > 1)
+            {
+                round_angle->y = round_angle->y - spread / 2.0
+                + spread * static_cast< double >(index) / (rounds - 1);
+            }
+            break;
+
+        case ShapeRing:
+            round_angle->y = round_angle->y
+            + 360.0 * static_cast< double >(index) / rounds;
+            break;
+
+        case ShapeBurst:
+        {
+            Vector3 ahead(0.0, 0.0, spacing * static_cast< double >(index));
+            Matrix44 rotation;
+            rotation.rotate(angle);
+            rotation.multiply(&ahead);
+            round_from->add(ahead);
+            break;
+        }
+    }
+
+    if (jitter == 0.0)
+    {
+        return;
+    }
+
+    const unsigned key = hash(seed ^ hash(trigger)) + 2 * index;
+    round_angle->x = round_angle->x + jitter * get_noise(key);
+    round_angle->y = round_angle->y + jitter * get_noise(key + 1);
+}
+
+} // namespace Ai
@@ -0,0 +1,49 @@
+#ifndef ROBOF__AI__FIRE_PATTERN_H_
+#define ROBOF__AI__FIRE_PATTERN_H_
+
+namespace GraphicsDatabase { class Vector3; }
+
+using GraphicsDatabase::Vector3;
+
+namespace Ai
+{
+
+class FirePattern
+{
+public:
+    enum Shape
+    {
+        ShapeSingle,
+        ShapeFan,   // spread horizontally over `spread` degrees
+        ShapeRing,  // spread horizontally all around
+        ShapeBurst, // in a line, `spacing` meters each
+    };
+
+public:
+    Shape shape;
+    int rounds;
+    double spread; // [degree]
+    double spacing; // [m]
+    double jitter; // [degree], max random offset of each round
+    unsigned seed;
+
+public:
+    FirePattern();
+    FirePattern(    Shape pattern_shape,
+                    int pattern_rounds,
+                    double pattern_spread,
+                    double pattern_spacing,
+                    double pattern_jitter,
+                    unsigned pattern_seed);
+    ~FirePattern();
+    void get_round( int index,
+                    unsigned trigger,
+                    const Vector3& from,
+                    const Vector3& angle,
+                    Vector3* round_from,
+                    Vector3* round_angle) const;
+};
+
+} // namespace Ai
+
+#endif
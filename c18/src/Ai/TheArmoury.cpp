@@ -1,14 +1,28 @@
 #include "Ai/TheArmoury.h"
+#include <algorithm>
 #include <cassert>
+#include <sstream>
+#include <vector>
+#include "GameLib/Framework.h"
 #include "GraphicsDatabase/Vector3.h"
+#include "Ai/BulletPool.h"
+#include "Ai/FirePattern.h"
+#include "Ai/ThreatIndex.h"
 #include "Bullet.h"
-#include "Cuboid.h"
+#include "BulletRenderer.h"
+#include "Hit.h"
 #include "Robo.h"
+#include "Segment.h"
+#include "SweepHash.h"
 #include "TheCollision.h"
 #include "TheDatabase.h"
+#include "TheEnvironment.h"
+#include "TheHitQueue.h"
 #include "TheHorizon.h"
+#include "TheProfiler.h"
 #include "Triangle.h"
 #include "View.h"
+#include "WeaponProfile.h"
 
 using GraphicsDatabase::Vector3;
 
@@ -18,152 +32,534 @@ namespace Ai
 namespace
 {
 
-const int MaxBulletPerRobo = 1000;
+const int MaxOwners        = 3; // see Robo::int_id
+const int KindSize         = WeaponProfile::KindSize;
+const double SweepCellSize = 2.0; // [m], a few frames of a bullet
+const int SweepBucketBits  = 12;
+const bool DoesReorder     = true;
+const unsigned ReorderFrames = 30;
 
+// one pool a kind of the weapons, a handle is kind * pool_size_ + the handle
+// in the pool
 class Impl
 {
 private:
-    Bullet* bullets_;
+    int max_bullets_per_robo_;
+    int pool_size_; // for two robos
+    BulletPool* pools_[KindSize];
+    BulletRenderer* renderer_;
+    unsigned reorder_frames_;
+    int live_counts_[MaxOwners];
+    unsigned triggers_[MaxOwners];
+    std::vector< Bullet* > homings_;
+    ThreatIndex threats_;
+    bool are_threats_dirty_; // indexed by the first query after an update
+    SweepHash sweep_hash_;
+    std::vector< Bullet* > sweeps_;
+    std::vector< int > interceptors_;
+    std::vector< int > found_;
+    int hashed_count_;
+    int visited_count_;
+    int tested_count_;
+    int intercepted_count_;
+    int collision_test_count_; // of the bullets and the others, a frame
 
 public:
-    Impl();
+    Impl(int max_bullets_per_robo);
     ~Impl();
-    void draw(const View& view) const;
-    bool fire(  const Robo& robo,
+    void burn_at(int handle, const Vector3& at);
+    int collision_test_count() const;
+    void draw(const View& view);
+    const Bullet* find(int handle) const;
+    int fire(   const Robo& robo,
                 const Vector3& from,
-                const Vector3& direction,
+                const Vector3& angle,
                 const Robo* opponent,
-                const bool is_locking_on);
+                const WeaponProfile& profile);
+    void find_threats(  const Robo& robo,
+                        double radius,
+                        double seconds,
+                        std::vector< int >* handles);
+    void intercept();
     void make_collision(TheHorizon horizon);
     void make_collision(Robo* target);
+    int live_count() const;
+    void print(std::ostringstream* oss) const;
     void update();
+
+private:
+    void guide_homings();
+    void index_threats();
+    template< int Kind >
+    void update_pool();
 };
 
-Impl::Impl()
+Impl::Impl(int max_bullets_per_robo)
+:   max_bullets_per_robo_(max_bullets_per_robo),
+    pool_size_(2 * max_bullets_per_robo),
+    renderer_(0),
+    reorder_frames_(0),
+    homings_(),
+    threats_(),
+    are_threats_dirty_(true),
+    sweep_hash_(SweepCellSize, SweepBucketBits),
+    sweeps_(),
+    interceptors_(),
+    found_(),
+    hashed_count_(0),
+    visited_count_(0),
+    tested_count_(0),
+    intercepted_count_(0),
+    collision_test_count_(0)
 {
-    bullets_ = new Bullet[2 * MaxBulletPerRobo];
+    for (int i = 0; i < KindSize; ++i)
+    {
+        pools_[i] = new BulletPool(pool_size_);
+    }
+
+    for (int i = 0; i < MaxOwners; ++i)
+    {
+        live_counts_[i] = 0;
+        triggers_[i] = 0;
+    }
+
+    homings_.reserve(pool_size_);
+    sweeps_.reserve(KindSize * pool_size_);
     TheDatabase::instance().create_model("bullet", "bullet");
+    renderer_ = new BulletRenderer();
 }
 
 Impl::~Impl()
 {
-    delete[] bullets_;
-    bullets_ = 0;
+    for (int i = 0; i < KindSize; ++i)
+    {
+        SAFE_DELETE(pools_[i]);
+    }
+
+    SAFE_DELETE(renderer_);
 }
 
-void Impl::draw(const View& view) const
+// by the hit queue, the bullet stays until its next update
+void Impl::burn_at(int handle, const Vector3& at)
 {
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
+    assert(handle >= 0 && handle < KindSize * pool_size_);
+    Bullet* bullet = pools_[handle / pool_size_]->find(handle % pool_size_);
+    assert(bullet);
+    bullet->burn_at(at);
+}
+
+void Impl::draw(const View& view)
+{
+    renderer_->clear();
+
+    for (int kind = 0; kind < KindSize; ++kind)
     {
-        bullets_[i].draw(view);
+        const BulletPool* pool = pools_[kind];
+
+        for (int i = 0; i < pool->size(); ++i)
+        {
+            renderer_->add(*pool->at(i)->point(), pool->at(i)->basis());
+        }
     }
+
+    renderer_->draw(view);
 }
 
-namespace
+// returns 0 when the bullet has been released
+const Bullet* Impl::find(int handle) const
 {
+    assert(handle >= 0 && handle < KindSize * pool_size_);
+    return pools_[handle / pool_size_]->find(handle % pool_size_);
+}
 
-int count_bullet(int id, const Bullet* bullets)
+// appends to the pool of the kind, costs by the rounds, not by the pool
+int Impl::fire( const Robo& robo,
+                const Vector3& from,
+                const Vector3& angle,
+                const Robo* opponent,
+                const WeaponProfile& profile)
 {
-    int count = 0;
+    const int id = robo.int_id();
+    assert(id >= 0 && id < MaxOwners);
+
+    const int kind = profile.kind;
+    const FirePattern& pattern = profile.pattern;
+
+    int rounds = std::min(  pattern.rounds,
+                            max_bullets_per_robo_ - live_counts_[id]);
+    rounds = std::min(rounds, pool_size_ - pools_[kind]->size());
 
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
+    if (rounds <= 0)
     {
-        if (bullets[i].is_owned_by(id))
-        {
-            ++count;
-        }
+        return 0;
     }
 
-    return count;
+    const unsigned trigger = triggers_[id];
+    triggers_[id] = triggers_[id] + 1;
+
+    Vector3 round_from;
+    Vector3 round_angle;
+
+    for (int i = 0; i < rounds; ++i)
+    {
+        pattern.get_round(i, trigger, from, angle, &round_from, &round_angle);
+        int handle = 0;
+        Bullet* bullet = pools_[kind]->append(&handle);
+        bullet->initialize( id,
+                            kind * pool_size_ + handle,
+                            profile,
+                            round_from,
+                            round_angle,
+                            &robo,
+                            opponent);
+    }
+    live_counts_[id] = live_counts_[id] + rounds;
+
+    return rounds;
+}
+
+void Impl::find_threats(    const Robo& robo,
+                            double radius,
+                            double seconds,
+                            std::vector< int >* handles)
+{
+    if (are_threats_dirty_)
+    {
+        index_threats();
+        are_threats_dirty_ = false;
+    }
+
+    threats_.find(*robo.center(), radius, seconds, robo.int_id(), handles);
+}
+
+namespace
+{
+
+// the corners of the box of the locus, grown by the radius of the bullet
+void get_swept_box(const Bullet& bullet, Vector3* min, Vector3* max)
+{
+    const Segment segment = bullet.locus_segment();
+    const double r = bullet.profile()->radius;
+    min->set(   std::min(segment.from.x, segment.to.x) - r,
+                std::min(segment.from.y, segment.to.y) - r,
+                std::min(segment.from.z, segment.to.z) - r);
+    max->set(   std::max(segment.from.x, segment.to.x) + r,
+                std::max(segment.from.y, segment.to.y) + r,
+                std::max(segment.from.z, segment.to.z) + r);
 }
 
 } // namespace -
 
-bool Impl::fire(    const Robo& robo,
-                    const Vector3& from,
-                    const Vector3& angle,
-                    const Robo* opponent,
-                    const bool is_locking_on)
+// The bullets of the weapons which can intercept hit the bullets of the
+// others.  Only they look up the hash, so no interceptor costs nothing.
+// Both boxes are grown by the radii, so the pairs within the sum of them
+// are found across the cells.  The build and the queries have their own
+// zones in the profiler.
+void Impl::intercept()
 {
-    int count = count_bullet(robo.int_id(), bullets_);
+    hashed_count_ = 0;
+    visited_count_ = 0;
+    tested_count_ = 0;
+    intercepted_count_ = 0;
 
-    if (count >= MaxBulletPerRobo)
+    if (!TheEnvironment::DoesInterceptBullets)
     {
-        return false;
+        return;
     }
 
-    bool did_fire = false;
+    sweeps_.clear();
+    interceptors_.clear();
 
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
+    for (int kind = 0; kind < KindSize; ++kind)
     {
-        if (bullets_[i].is_owned())
+        // a ray is not hit by the others, and its box is the whole range
+        if (kind == WeaponProfile::KindBeam)
         {
             continue;
         }
 
-        bullets_[i].initialize( robo.int_id(),
-                                from,
-                                angle,
-                                &robo,
-                                opponent,
-                                is_locking_on);
-        did_fire = true;
-        break;
+        BulletPool* pool = pools_[kind];
+
+        for (int i = 0; i < pool->size(); ++i)
+        {
+            Bullet* bullet = pool->at(i);
+
+            if (bullet->did_collide())
+            {
+                continue;
+            }
+
+            if (bullet->profile()->can_intercept)
+            {
+                interceptors_.push_back(static_cast< int >(sweeps_.size()));
+            }
+
+            sweeps_.push_back(bullet);
+        }
+    }
+
+    if (interceptors_.empty())
+    {
+        return;
     }
 
-    return did_fire;
-}
+    Vector3 min;
+    Vector3 max;
 
-void Impl::make_collision(TheHorizon horizon)
-{
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
     {
-        if (!bullets_[i].is_owned())
+        TheProfiler::Zone zone("intercept hash build");
+        sweep_hash_.clear();
+
+        for (size_t i = 0; i < sweeps_.size(); ++i)
         {
-            continue;
+            get_swept_box(*sweeps_.at(i), &min, &max);
+            sweep_hash_.add(static_cast< int >(i), min, max);
         }
 
-        if (bullets_[i].did_collide())
+        sweep_hash_.build();
+        hashed_count_ = static_cast< int >(sweep_hash_.entries_size());
+    }
+
+    TheProfiler::Zone zone("intercept hash query");
+    std::vector< Hit >* hits = TheHitQueue::instance().buffer(0);
+
+    for (size_t i = 0; i < interceptors_.size(); ++i)
+    {
+        const int a = interceptors_.at(i);
+        Bullet* bullet = sweeps_.at(a);
+        get_swept_box(*bullet, &min, &max);
+
+        found_.clear();
+        visited_count_ = visited_count_ + sweep_hash_.find(min, max, &found_);
+
+        for (size_t j = 0; j < found_.size(); ++j)
         {
-            continue;
+            const int b = found_.at(j);
+            Bullet* other = sweeps_.at(b);
+
+            if (other->owner_id() == bullet->owner_id())
+            {
+                continue;
+            }
+
+            // a pair of the interceptors is tested once
+            if (other->profile()->can_intercept && b < a)
+            {
+                continue;
+            }
+
+            ++tested_count_;
+
+            if (TheCollision::burn(bullet, other, hits))
+            {
+                ++intercepted_count_;
+            }
         }
+    }
+}
+
+void Impl::make_collision(TheHorizon horizon)
+{
+    std::vector< Hit >* hits = TheHitQueue::instance().buffer(0);
+
+    for (int kind = 0; kind < KindSize; ++kind)
+    {
+        BulletPool* pool = pools_[kind];
+
+        for (int i = 0; i < pool->size(); ++i)
+        {
+            Bullet* bullet = pool->at(i);
 
-        TheCollision::burn(&bullets_[i], horizon);
+            if (bullet->did_collide())
+            {
+                continue;
+            }
+
+            TheCollision::burn(bullet, horizon, hits);
+            ++collision_test_count_;
+        }
     }
 }
 
 void Impl::make_collision(Robo* target)
 {
+    std::vector< Hit >* hits = TheHitQueue::instance().buffer(0);
     std::vector< Triangle > triangles;
     target->get_triangles(&triangles);
-    Cuboid cuboid = target->locus_cuboid();
+    const Segment locus = target->locus_segment();
+    const double radius = target->collider_radius();
 
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
+    for (int kind = 0; kind < KindSize; ++kind)
     {
-        if (!bullets_[i].is_owned())
+        BulletPool* pool = pools_[kind];
+
+        for (int i = 0; i < pool->size(); ++i)
         {
-            continue;
+            Bullet* bullet = pool->at(i);
+
+            if (bullet->did_collide())
+            {
+                continue;
+            }
+
+            if (bullet->is_owned_by(target->int_id()))
+            {
+                continue;
+            }
+
+            TheCollision::burn( bullet,
+                                target,
+                                locus,
+                                radius,
+                                triangles,
+                                hits);
+            ++collision_test_count_;
+        }
+    }
+}
+
+// with the tests of the interception
+int Impl::collision_test_count() const
+{
+    return collision_test_count_ + tested_count_;
+}
+
+int Impl::live_count() const
+{
+    int count = 0;
+
+    for (int kind = 0; kind < KindSize; ++kind)
+    {
+        count = count + pools_[kind]->size();
+    }
+
+    return count;
+}
+
+void Impl::print(std::ostringstream* oss) const
+{
+    *oss << "intercept: ";
+    *oss << hashed_count_;
+    *oss << " hashed, ";
+    *oss << visited_count_;
+    *oss << " cells, ";
+    *oss << tested_count_;
+    *oss << " tests, ";
+    *oss << intercepted_count_;
+    *oss << " hits";
+    *oss << ", ";
+    renderer_->print(oss);
+}
+
+void Impl::update()
+{
+    collision_test_count_ = 0;
+
+    update_pool< WeaponProfile::KindBallistic >();
+    update_pool< WeaponProfile::KindBoosted >();
+    update_pool< WeaponProfile::KindHoming >();
+    update_pool< WeaponProfile::KindBeam >();
+    guide_homings();
+
+    reorder_frames_ = reorder_frames_ + 1;
+
+    if (DoesReorder && reorder_frames_ >= ReorderFrames)
+    {
+        for (int kind = 0; kind < KindSize; ++kind)
+        {
+            pools_[kind]->reorder();
         }
 
-        if (bullets_[i].did_collide())
+        reorder_frames_ = 0;
+    }
+
+    are_threats_dirty_ = true;
+}
+
+namespace
+{
+
+bool is_less_target(const Bullet* a, const Bullet* b)
+{
+    return a->homing_target() < b->homing_target();
+}
+
+} // namespace -
+
+// guides every group of the bullets homing to the same robo at once
+void Impl::guide_homings()
+{
+    homings_.clear();
+    BulletPool* pool = pools_[WeaponProfile::KindHoming];
+
+    for (int i = 0; i < pool->size(); ++i)
+    {
+        if (pool->at(i)->homing_target())
         {
-            continue;
+            homings_.push_back(pool->at(i));
         }
+    }
+
+    std::sort(homings_.begin(), homings_.end(), is_less_target);
+
+    size_t begin = 0;
+
+    while (begin < homings_.size())
+    {
+        const Robo* target = homings_.at(begin)->homing_target();
+        size_t end = begin + 1;
+
+        while (end < homings_.size()
+                && homings_.at(end)->homing_target() == target)
+        {
+            ++end;
+        }
+
+        Bullet::guide(&homings_.at(begin), end - begin, *target->center());
+        begin = end;
+    }
+}
+
+void Impl::index_threats()
+{
+    threats_.clear();
 
-        if (bullets_[i].is_owned_by(target->int_id()))
+    for (int kind = 0; kind < KindSize; ++kind)
+    {
+        // the rays hit in the frame they are fired, no one dodges them
+        if (kind == WeaponProfile::KindBeam)
         {
             continue;
         }
 
-        TheCollision::burn(&bullets_[i], target, cuboid, triangles);
+        threats_.add(pools_[kind], kind * pool_size_);
     }
+
+    threats_.build();
 }
 
-void Impl::update()
+template< int Kind >
+void Impl::update_pool()
 {
-    for (int i = 0; i < 2 * MaxBulletPerRobo; ++i)
+    BulletPool* pool = pools_[Kind];
+    int i = 0;
+
+    while (i < pool->size())
     {
-        bullets_[i].update();
+        Bullet* bullet = pool->at(i);
+        const int owner_id = bullet->owner_id();
+
+        bullet->update< Kind >();
+
+        if (bullet->is_owned())
+        {
+            ++i;
+            continue;
+        }
+
+        // the last one is moved to the slot, then updated there
+        live_counts_[owner_id] = live_counts_[owner_id] - 1;
+        pool->release(i);
     }
 }
 
@@ -171,10 +567,11 @@ Impl* g_impl = 0;
 
 } // namespace -
 
-void TheArmoury::create()
+void TheArmoury::create(int max_bullets_per_robo)
 {
     assert(!g_impl);
-    g_impl = new Impl();
+    assert(max_bullets_per_robo > 0);
+    g_impl = new Impl(max_bullets_per_robo);
 }
 
 void TheArmoury::destroy()
@@ -198,17 +595,42 @@ TheArmoury::TheArmoury() {}
 
 TheArmoury::~TheArmoury() {}
 
+void TheArmoury::burn_at(int handle, const Vector3& at) const
+{
+    g_impl->burn_at(handle, at);
+}
+
+int TheArmoury::collision_test_count() const
+{
+    return g_impl->collision_test_count();
+}
+
 void TheArmoury::draw(const View& view) const { g_impl->draw(view); }
 
-bool TheArmoury::fire(  const Robo& robo,
+int TheArmoury::fire(   const Robo& robo,
                         const Vector3& from,
-                        const Vector3& direction,
+                        const Vector3& angle,
                         const Robo* opponent,
-                        const bool is_locking_on) const
+                        const WeaponProfile& profile) const
+{
+    return g_impl->fire(robo, from, angle, opponent, profile);
+}
+
+const Bullet* TheArmoury::find(int handle) const
+{
+    return g_impl->find(handle);
+}
+
+void TheArmoury::find_threats(  const Robo& robo,
+                                double radius,
+                                double seconds,
+                                std::vector< int >* handles) const
 {
-    return g_impl->fire(robo, from, direction, opponent, is_locking_on);
+    g_impl->find_threats(robo, radius, seconds, handles);
 }
 
+void TheArmoury::intercept() const { g_impl->intercept(); }
+
 template< class T >
 void TheArmoury::make_collision(T to_what) const
 {
@@ -218,6 +640,13 @@ void TheArmoury::make_collision(T to_what) const
 template void TheArmoury::make_collision(TheHorizon) const;
 template void TheArmoury::make_collision(Robo*) const;
 
+int TheArmoury::live_count() const { return g_impl->live_count(); }
+
+void TheArmoury::print(std::ostringstream* oss) const
+{
+    g_impl->print(oss);
+}
+
 void TheArmoury::update() const { g_impl->update(); }
 
 } // namespace Ai
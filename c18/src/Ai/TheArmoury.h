@@ -1,10 +1,14 @@
 #ifndef ROBOF__AI__THE_ARMOURY_H_
 #define ROBOF__AI__THE_ARMOURY_H_
+#include <sstream>
+#include <vector>
 
 namespace GraphicsDatabase { class Vector3; }
+class Bullet;
 class Robo;
 class TheHorizon;
 class View;
+class WeaponProfile;
 
 using GraphicsDatabase::Vector3;
 
@@ -14,7 +18,7 @@ namespace Ai
 class TheArmoury
 {
 public:
-    static void create();
+    static void create(int max_bullets_per_robo); // live at once
     static void destroy();
     static TheArmoury instance();
     static bool did_create();
@@ -24,14 +28,24 @@ private:
 
 public:
     ~TheArmoury();
+    void burn_at(int handle, const Vector3& at) const;
+    int collision_test_count() const; // in the frame
     void draw(const View& view) const;
-    bool fire(  const Robo& robo,
+    const Bullet* find(int handle) const;
+    int fire(   const Robo& robo,
                 const Vector3& from,
                 const Vector3& angle,
                 const Robo* opponent,
-                const bool is_locking_on) const;
+                const WeaponProfile& profile) const;
+    void find_threats(  const Robo& robo,
+                        double radius,
+                        double seconds,
+                        std::vector< int >* handles) const;
+    void intercept() const;
     template< class T >
     void make_collision(T to_what) const;
+    int live_count() const; // of the bullets
+    void print(std::ostringstream* oss) const;
     void update() const;
 };
 
@@ -0,0 +1,235 @@
+#include "Ai/ThreatIndex.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+#include "Ai/BulletPool.h"
+#include "Bullet.h"
+#include "Segment.h"
+#include "SweepHash.h"
+#include "TheEnvironment.h"
+
+using GraphicsDatabase::Vector3;
+
+namespace Ai
+{
+
+namespace
+{
+
+const int BucketSize        = 8;
+const double BucketSeconds  = 0.25; // 2 seconds ahead in all
+const double CellSize       = 8.0; // [m], a bucket of a fast bullet
+const int HashBits          = 10;
+const double StepSeconds    = 1.0 / 32.0; // of the exact test
+
+double get_squared_distance(const Segment& segment, const Vector3& point)
+{
+    Vector3 direction(segment.to);
+    direction.subtract(segment.from);
+    Vector3 from_point(point);
+    from_point.subtract(segment.from);
+
+    const double length2 = direction.squared_length();
+    double t = length2 > 0.0 ? from_point.dot(direction) / length2 : 0.0;
+    t = t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t;
+
+    direction.multiply(t);
+    from_point.subtract(direction);
+    return from_point.squared_length();
+}
+
+} // namespace -
+
+ThreatIndex::ThreatIndex()
+:   spans_(), size_(0), gravity_(0.0),
+    buckets_(BucketSize, SweepHash(CellSize, HashBits)),
+    found_(), stamps_(), stamp_(0)
+{}
+
+ThreatIndex::~ThreatIndex() {}
+
+// the rays are not added, all the others fall
+void ThreatIndex::add(const BulletPool* pool, int handle_base)
+{
+    Span span;
+    span.pool = pool;
+    span.handle_base = handle_base;
+    span.first = size_;
+    spans_.push_back(span);
+    size_ = size_ + pool->size();
+}
+
+// Puts the box of each piece of the paths in its bucket.  A piece of a
+// parabola is in the box of its ends, and of its top if it is on the way.
+void ThreatIndex::build()
+{
+    for (int k = 0; k < BucketSize; ++k)
+    {
+        buckets_.at(k).clear();
+    }
+
+    gravity_ = TheEnvironment::gravity_acceleration();
+
+    Vector3 from;
+    Vector3 to;
+    Vector3 top;
+
+    for (size_t s = 0; s < spans_.size(); ++s)
+    {
+        const Span& span = spans_.at(s);
+
+        for (int slot = 0; slot < span.pool->size(); ++slot)
+        {
+            const Bullet& bullet = *span.pool->at(slot);
+            const int index = span.first + slot;
+            const double top_t
+            = gravity_ > 0.0 ? bullet.velocity()->y / gravity_ : -1.0;
+
+            for (int k = 0; k < BucketSize; ++k)
+            {
+                const double begin = BucketSeconds * k;
+                const double end = begin + BucketSeconds;
+                get_point(bullet, begin, &from);
+                get_point(bullet, end, &to);
+
+                if (top_t > begin && top_t < end)
+                {
+                    get_point(bullet, top_t, &top);
+
+                    if (from.y > to.y)
+                    {
+                        from.y = top.y;
+                    }
+                    else
+                    {
+                        to.y = top.y;
+                    }
+                }
+
+                buckets_.at(k).add(index, from, to);
+            }
+        }
+    }
+
+    for (int k = 0; k < BucketSize; ++k)
+    {
+        buckets_.at(k).build();
+    }
+
+    stamps_.assign(size_, stamp_);
+}
+
+void ThreatIndex::clear()
+{
+    spans_.clear();
+    size_ = 0;
+}
+
+// appends the handles of the bullets passing within the radius of the point
+// in the seconds, up to BucketSize * BucketSeconds
+void ThreatIndex::find( const Vector3& point,
+                        double radius,
+                        double seconds,
+                        int ignored_owner_id,
+                        std::vector< int >* handles)
+{
+    const Vector3 min(point.x - radius, point.y - radius, point.z - radius);
+    const Vector3 max(point.x + radius, point.y + radius, point.z + radius);
+    const int bucket_size
+    = std::min(
+        BucketSize,
+        static_cast< int >(seconds / BucketSeconds) + 1);
+
+    stamp_ = stamp_ + 1;
+
+    for (int k = 0; k < bucket_size; ++k)
+    {
+        found_.clear();
+        buckets_.at(k).find(min, max, &found_);
+
+        for (size_t i = 0; i < found_.size(); ++i)
+        {
+            const int index = found_.at(i);
+
+            if (stamps_.at(index) == stamp_)
+            {
+                continue;
+            }
+
+            stamps_.at(index) = stamp_;
+
+            const Span& span = get_span(index);
+            const int slot = index - span.first;
+            const Bullet& bullet = *span.pool->at(slot);
+
+            if (bullet.owner_id() == ignored_owner_id)
+            {
+                continue;
+            }
+
+            if (!does_pass_within(bullet, point, radius, seconds))
+            {
+                continue;
+            }
+
+            handles->push_back(span.handle_base + span.pool->handle(slot));
+        }
+    }
+}
+
+void ThreatIndex::get_point(    const Bullet& bullet,
+                                double t,
+                                Vector3* point) const
+{
+    const Vector3* from = bullet.point();
+    const Vector3* velocity = bullet.velocity();
+    point->x = from->x + velocity->x * t;
+    point->y = from->y + velocity->y * t - 0.5 * gravity_ * t * t;
+    point->z = from->z + velocity->z * t;
+}
+
+// a few spans, one a kind of the weapons
+const ThreatIndex::Span& ThreatIndex::get_span(int index) const
+{
+    assert(index >= 0 && index < size_);
+    size_t s = spans_.size() - 1;
+
+    while (spans_.at(s).first > index)
+    {
+        --s;
+    }
+
+    return spans_.at(s);
+}
+
+// By the chords of short steps.  A chord is off the parabola by g h^2 / 8 at
+// most, so the radius is widened by it.
+bool ThreatIndex::does_pass_within( const Bullet& bullet,
+                                    const Vector3& point,
+                                    double radius,
+                                    double seconds) const
+{
+    const double sag = gravity_ * StepSeconds * StepSeconds / 8.0;
+    const double reach2 = (radius + sag) * (radius + sag);
+
+    Vector3 from;
+    Vector3 to;
+    get_point(bullet, 0.0, &from);
+
+    for (double t = 0.0; t < seconds; t = t + StepSeconds)
+    {
+        get_point(bullet, std::min(t + StepSeconds, seconds), &to);
+
+        if (get_squared_distance(Segment(from, to), point) <= reach2)
+        {
+            return true;
+        }
+
+        from = to;
+    }
+
+    return false;
+}
+
+} // namespace Ai
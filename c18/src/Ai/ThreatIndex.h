@@ -0,0 +1,64 @@
+#ifndef ROBOF__AI__THREAT_INDEX_H_
+#define ROBOF__AI__THREAT_INDEX_H_
+#include <vector>
+#include "SweepHash.h"
+
+namespace GraphicsDatabase { class Vector3; }
+class Bullet;
+
+using GraphicsDatabase::Vector3;
+
+namespace Ai
+{
+
+class BulletPool;
+
+// Where the live bullets will be in the next seconds, for the bots to dodge.
+// The paths are cut into time buckets, the box of each piece is put in the
+// spatial hash of its bucket.  Rebuilt once a frame, queried by every robo.
+// The bullets are read in their pools, so the index is good until the pools
+// are updated again.
+class ThreatIndex
+{
+private:
+    // the live bullets of a pool, the index of a bullet is first + its slot
+    struct Span
+    {
+        const BulletPool* pool;
+        int handle_base; // of the pool in TheArmoury
+        int first;
+    };
+
+private:
+    std::vector< Span > spans_;
+    int size_;
+    double gravity_;
+    std::vector< SweepHash > buckets_;
+    std::vector< int > found_;
+    std::vector< unsigned > stamps_;
+    unsigned stamp_;
+
+public:
+    ThreatIndex();
+    ~ThreatIndex();
+    void add(const BulletPool* pool, int handle_base);
+    void build();
+    void clear();
+    void find(  const Vector3& point,
+                double radius,
+                double seconds,
+                int ignored_owner_id,
+                std::vector< int >* handles);
+
+private:
+    void get_point(const Bullet& bullet, double t, Vector3* point) const;
+    const Span& get_span(int index) const;
+    bool does_pass_within(  const Bullet& bullet,
+                            const Vector3& point,
+                            double radius,
+                            double seconds) const;
+};
+
+} // namespace Ai
+
+#endif
@@ -0,0 +1,254 @@
+#include "Animation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DataTree.h"
+
+namespace
+{
+
+const double SamplesPerSecond = 60.0;
+
+const char* const GroupNames[] = { "position", "angle" };
+const char* const AxisNames[] = { "x", "y", "z" };
+
+Animation::Completion to_completion(const std::string& name)
+{
+    if (name == "polynomial2")
+    {
+        return Animation::CompletionPolynomial2;
+    }
+    else if (name == "polynomial3")
+    {
+        return Animation::CompletionPolynomial3;
+    }
+
+    assert(name == "linear");
+    return Animation::CompletionLinear;
+}
+
+} // namespace -
+
+// The speeds of a quadratic spline go on from the given one, as each piece
+// has the speed of the last at its start.
+void Animation::load(const DataTree& tree, int node, Animation* animation)
+{
+    animation->id_ = tree.string(tree.find(node, "id"));
+
+    for (int group = 0; group < 2; ++group)
+    {
+        const int group_node = tree.find(node, GroupNames[group]);
+
+        for (int axis = 0; axis < 3 && group_node >= 0; ++axis)
+        {
+            const int curve_node = tree.find(group_node, AxisNames[axis]);
+
+            if (curve_node < 0)
+            {
+                continue;
+            }
+
+            Curve& curve = animation->curves_[group * 3 + axis];
+            const int completion_node = tree.find(curve_node, "completion");
+            curve.completion
+            = completion_node < 0
+            ? CompletionLinear
+            : to_completion(tree.string(completion_node));
+            curve.period = tree.number(tree.find(curve_node, "period"));
+            assert(curve.period > 0.0);
+
+            const int points_node = tree.find(curve_node, "points");
+
+            for (int i = 0; i < tree.size(points_node); ++i)
+            {
+                const int point_node = tree.at(points_node, i);
+                Point point;
+                point.t = tree.number(tree.at(point_node, 0));
+                point.value = tree.number(tree.at(point_node, 1));
+                point.speed
+                = tree.size(point_node) > 2
+                ? tree.number(tree.at(point_node, 2))
+                : 0.0;
+                assert(curve.points.empty() || curve.points.back().t < point.t);
+                curve.points.push_back(point);
+            }
+
+            assert(!curve.points.empty());
+
+            if (curve.completion != CompletionPolynomial2)
+            {
+                resample(&curve);
+                continue;
+            }
+
+            const int speed_at_node = tree.find(curve_node, "speed_at");
+            const double speed_t
+            = speed_at_node < 0
+            ? curve.points.front().t
+            : tree.number(tree.at(speed_at_node, 0));
+            std::vector< Point >& points = curve.points;
+            size_t at = 0;
+
+            while (at < points.size() && points.at(at).t != speed_t)
+            {
+                ++at;
+            }
+
+            assert(at < points.size());
+            points.at(at).speed
+            = speed_at_node < 0 ? 0.0 : tree.number(tree.at(speed_at_node, 1));
+
+            for (size_t i = at + 1; i < points.size(); ++i)
+            {
+                const Point& from = points.at(i - 1);
+                points.at(i).speed
+                = 2.0 * (points.at(i).value - from.value)
+                / (points.at(i).t - from.t)
+                - from.speed;
+            }
+
+            for (size_t i = at; i > 0; --i)
+            {
+                const Point& to = points.at(i);
+                points.at(i - 1).speed
+                = 2.0 * (to.value - points.at(i - 1).value)
+                / (to.t - points.at(i - 1).t)
+                - to.speed;
+            }
+
+            resample(&curve);
+        }
+    }
+}
+
+Animation::Animation()
+: id_()
+{
+    for (int i = 0; i < ChannelSize; ++i)
+    {
+        curves_[i].completion = CompletionLinear;
+        curves_[i].period = 1.0;
+    }
+}
+
+Animation::~Animation() {}
+
+int Animation::bytes() const
+{
+    size_t size = 0;
+
+    for (int i = 0; i < ChannelSize; ++i)
+    {
+        size = size + curves_[i].samples.size() * sizeof(float);
+    }
+
+    return static_cast< int >(size);
+}
+
+bool Animation::has(Channel channel) const
+{
+    return !curves_[channel].samples.empty();
+}
+
+const std::string& Animation::id() const { return id_; }
+
+void Animation::print(std::ostringstream* oss) const
+{
+    int channels = 0;
+    int samples = 0;
+
+    for (int i = 0; i < ChannelSize; ++i)
+    {
+        channels = channels + (has(static_cast< Channel >(i)) ? 1 : 0);
+        samples = samples + static_cast< int >(curves_[i].samples.size());
+    }
+
+    *oss << id_;
+    *oss << ": channels: ";
+    *oss << channels;
+    *oss << ", samples: ";
+    *oss << samples;
+    *oss << ", bytes: ";
+    *oss << bytes();
+}
+
+// the samples are of the times 0, 1 / (size - 1), ... and 1
+double Animation::sample(Channel channel, double seconds) const
+{
+    const std::vector< float >& samples = curves_[channel].samples;
+    assert(samples.size() >= 2);
+
+    double t = std::fmod(seconds / curves_[channel].period, 1.0);
+    t = t < 0.0 ? t + 1.0 : t;
+    const double at = t * static_cast< double >(samples.size() - 1);
+    const size_t i = std::min(static_cast< size_t >(at), samples.size() - 2);
+    const double rate = at - static_cast< double >(i);
+    return samples[i] + (samples[i + 1] - samples[i]) * rate;
+}
+
+// searches the points for the piece, outside of them the end values
+double Animation::evaluate(const Curve& curve, double t)
+{
+    const std::vector< Point >& points = curve.points;
+    assert(!points.empty());
+
+    if (t <= points.front().t)
+    {
+        return points.front().value;
+    }
+
+    size_t i = 1;
+
+    while (i < points.size() && points.at(i).t < t)
+    {
+        ++i;
+    }
+
+    if (i == points.size())
+    {
+        return points.back().value;
+    }
+
+    const Point& from = points.at(i - 1);
+    const Point& to = points.at(i);
+    const double h = to.t - from.t;
+    const double s = t - from.t;
+    const double rate = s / h;
+
+    if (curve.completion == CompletionPolynomial2)
+    {
+        const double a = (to.value - from.value - from.speed * h) / (h * h);
+        return from.value + from.speed * s + a * s * s;
+    }
+    else if (curve.completion == CompletionPolynomial3)
+    {
+        // Hermite
+        const double rate2 = rate * rate;
+        const double rate3 = rate2 * rate;
+        return  (2.0 * rate3 - 3.0 * rate2 + 1.0) * from.value
+                + (rate3 - 2.0 * rate2 + rate) * h * from.speed
+                + (-2.0 * rate3 + 3.0 * rate2) * to.value
+                + (rate3 - rate2) * h * to.speed;
+    }
+
+    return from.value + (to.value - from.value) * rate;
+}
+
+// the points are not needed any more
+void Animation::resample(Curve* curve)
+{
+    const double count = std::ceil(curve->period * SamplesPerSecond);
+    const int size = std::max(2, static_cast< int >(count) + 1);
+    curve->samples.resize(size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        const double t = static_cast< double >(i) / (size - 1);
+        curve->samples.at(i) = static_cast< float >(evaluate(*curve, t));
+    }
+
+    std::vector< Point >().swap(curve->points);
+}
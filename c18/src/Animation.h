@@ -0,0 +1,73 @@
+#ifndef ROBOFANIMATION_H_
+#define ROBOFANIMATION_H_
+#include <sstream>
+#include <string>
+#include <vector>
+
+class DataTree;
+
+// An entry of "animations" in data/models.json.  Each channel is a curve
+// through the points of a period, the times of the points normalized to
+// [0, 1], and loops.  "polynomial2" curves are quadratic splines from the
+// speed of "speed_at", "polynomial3" ones are cubic from the speeds of the
+// points.  The speeds are per period.  The curves are resampled at load
+// at a fixed rate, so a sample is a lookup of the two around the time.
+class Animation
+{
+public:
+    enum Channel
+    {
+        ChannelPositionX,
+        ChannelPositionY,
+        ChannelPositionZ,
+        ChannelAngleX,
+        ChannelAngleY,
+        ChannelAngleZ,
+        ChannelSize
+    };
+
+    enum Completion
+    {
+        CompletionLinear,
+        CompletionPolynomial2,
+        CompletionPolynomial3
+    };
+
+private:
+    struct Point
+    {
+        double t;
+        double value;
+        double speed;
+    };
+
+    struct Curve
+    {
+        Completion completion;
+        double period; // [s]
+        std::vector< Point > points; // until resampled
+        std::vector< float > samples; // empty if the channel is not animated
+    };
+
+private:
+    std::string id_;
+    Curve curves_[ChannelSize];
+
+public:
+    static void load(const DataTree& tree, int node, Animation* animation);
+
+public:
+    Animation();
+    ~Animation();
+    int bytes() const; // of the samples
+    bool has(Channel channel) const;
+    const std::string& id() const;
+    void print(std::ostringstream* oss) const;
+    double sample(Channel channel, double seconds) const;
+
+private:
+    static double evaluate(const Curve& curve, double t);
+    static void resample(Curve* curve);
+};
+
+#endif
@@ -0,0 +1,52 @@
+#include "BatchTransform.h"
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+namespace BatchTransform
+{
+
+// the image of an axis is a column
+void get_rows(const Matrix44& matrix, double rows[4][4])
+{
+    for (int column = 0; column < 4; ++column)
+    {
+        Vector3 axis(0.0, 0.0, 0.0);
+        axis.w = 0.0;
+        (&axis.x)[column] = 1.0;
+        matrix.multiply(&axis);
+
+        for (int row = 0; row < 4; ++row)
+        {
+            rows[row][column] = (&axis.x)[row];
+        }
+    }
+}
+
+void transform( const double rows[4][4],
+                const double* xs,
+                const double* ys,
+                const double* zs,
+                int size,
+                Vector3* results)
+{
+    for (int i = 0; i < size; ++i)
+    {
+        results[i].x
+        = rows[0][0] * xs[i] + rows[0][1] * ys[i] + rows[0][2] * zs[i]
+        + rows[0][3];
+        results[i].y
+        = rows[1][0] * xs[i] + rows[1][1] * ys[i] + rows[1][2] * zs[i]
+        + rows[1][3];
+        results[i].z
+        = rows[2][0] * xs[i] + rows[2][1] * ys[i] + rows[2][2] * zs[i]
+        + rows[2][3];
+        results[i].w
+        = rows[3][0] * xs[i] + rows[3][1] * ys[i] + rows[3][2] * zs[i]
+        + rows[3][3];
+    }
+}
+
+} // namespace BatchTransform
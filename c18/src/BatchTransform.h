@@ -0,0 +1,28 @@
+#ifndef ROBOFBATCHTRANSFORM_H_
+#define ROBOFBATCHTRANSFORM_H_
+
+namespace GraphicsDatabase { class Matrix44; }
+namespace GraphicsDatabase { class Vector3; }
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+// Homogeneous transforms of many points at once.  The rows of a matrix are
+// read once by projecting the axes, then the points go through a plain loop
+// over structure of arrays, left to the auto vectorizer.
+namespace BatchTransform
+{
+
+void get_rows(const Matrix44& matrix, double rows[4][4]);
+
+// w of the points is 1
+void transform( const double rows[4][4],
+                const double* xs,
+                const double* ys,
+                const double* zs,
+                int size,
+                Vector3* results);
+
+} // namespace BatchTransform
+
+#endif
@@ -3,16 +3,15 @@
 #include <cassert>
 #include <cmath>
 #include "GraphicsDatabase/Matrix44.h"
-#include "GraphicsDatabase/Model.h"
 #include "GraphicsDatabase/Vector3.h"
-#include "GameLib/Math.h"
+#include "BatchTransform.h"
 #include "Cuboid.h"
+#include "FastMath.h"
 #include "Robo.h"
 #include "Segment.h"
-#include "TheDatabase.h"
 #include "TheEnvironment.h"
 #include "TheTime.h"
-#include "View.h"
+#include "WeaponProfile.h"
 
 using GraphicsDatabase::Vector3;
 using GraphicsDatabase::Matrix44;
@@ -20,50 +19,82 @@ using GraphicsDatabase::Matrix44;
 namespace
 {
 
-const unsigned MaxAgeMs             = 10000;
-const double Scale                  = 0.2;
-const double Speed0                 = 50.0;
-const double SpeedMax               = 60.0;
-// const double Speed0     = 115.0;
-// const double SpeedMax   = 295.0;
-const unsigned BoostAfter           = 2 * 1000;
-// const unsigned BoostAfter   = 10 * 1000;
-const double BoostS                 = 1.0;
-// const double BoostS         = 2.0;
-const unsigned BoostMs              = static_cast< unsigned >(BoostS * 1000);
-const double DeltaSpeed             = (SpeedMax - Speed0) / BoostS;
-const double AbsAngleLimit          = 5.0e-3;
-const double AnglePerMs             = 20.0e-3 * static_cast< double >(MaxAgeMs);
-const double ActiveAngleLimit       = 30.0;
-const double VerticalAcceleration
-= 2.0 * TheEnvironment::GravityAcceleration * static_cast< double >(MaxAgeMs);
+const double AnglePerMs             = 20.0e-3; // per the max age [ms]
+const double VerticalAcceleration   = 2.0 * TheEnvironment::GravityAcceleration;
 const double VerticalAbsSpeedLimit
 = 2.0 * TheEnvironment::GravityAcceleration * 1e-3;
+const double AngleRefreshCosine     = 0.99985; // cos(1 degree)
+const bool DoesUseGuidanceLod       = true;
+const double GuidanceLodDistance    = 30.0; // [m]
+const unsigned GuidanceLodFrames    = 4;
+const int GuidanceLanes             = 4; // same as FastMath::atan2_4
+
+// what the update of each kind of the bullets does, decided at compile time
+template< int Kind >
+struct Traits
+{
+    static const bool HasBoost = false;
+    static const bool HasGravity = true;
+    static const bool IsRay = false;
+};
+
+template<>
+struct Traits< WeaponProfile::KindBoosted >
+{
+    static const bool HasBoost = true;
+    static const bool HasGravity = true;
+    static const bool IsRay = false;
+};
+
+template<>
+struct Traits< WeaponProfile::KindHoming >
+{
+    static const bool HasBoost = true;
+    static const bool HasGravity = true;
+    static const bool IsRay = false;
+};
 
-double calc_delta_speed(unsigned from, unsigned dt)
+template<>
+struct Traits< WeaponProfile::KindBeam >
 {
-    if (from + dt < BoostAfter)
+    static const bool HasBoost = false;
+    static const bool HasGravity = false;
+    static const bool IsRay = true;
+};
+
+double calc_delta_speed(    const WeaponProfile& profile,
+                            unsigned from,
+                            unsigned dt)
+{
+    if (from + dt < profile.boost_after_ms)
     {
         return 0.0;
     }
-    else if (from + dt > BoostAfter + BoostMs)
+    else if (from + dt > profile.boost_after_ms + profile.boost_ms)
     {
         return 0.0;
     }
 
     // ignore the case that
-    // from < BoostAfter; from + dt > BoostAfter
+    // from < boost_after_ms; from + dt > boost_after_ms
 
-    return DeltaSpeed * dt / 1e3;
+    return profile.delta_speed() * dt / 1e3;
 }
 
 } // namespace -
 
 Bullet::Bullet()
-:   owner_id_(-1), age_(0), is_homing_(false), did_collide_(false),
+:   owner_id_(-1), handle_(-1), age_(0), profile_(0), did_collide_(false),
     previous_point_(), current_point_(), velocity_(),
-    target_robo_(0)
-{}
+    direction_(0.0, 0.0, 1.0), angle_(), angle_direction_(0.0, 0.0, 1.0),
+    shooter_(0), target_robo_(0),
+    guidance_frames_(0), is_off_axis_(false)
+{
+    for (int i = 0; i < 9; ++i)
+    {
+        basis_[i] = i % 4 == 0 ? 1.0 : 0.0;
+    }
+}
 
 Bullet::~Bullet()
 {
@@ -71,76 +102,86 @@ Bullet::~Bullet()
 }
 
 void Bullet::initialize(    int id,
+                            int handle,
+                            const WeaponProfile& profile,
                             const Vector3& from,
                             const Vector3& angle,
                             const Robo* shooter,
-                            const Robo* opponent,
-                            bool is_homing)
+                            const Robo* opponent)
 {
     assert(id >= 0);
     owner_id_ = id;
+    handle_ = handle;
     age_ = 0;
-    is_homing_ = is_homing;
+    profile_ = &profile;
     previous_point_ = from;
     current_point_ = from;
 
-    if (!is_homing_)
+    const bool is_homing
+    = profile.kind == WeaponProfile::KindHoming && opponent;
+
+    if (!is_homing)
     {
         Matrix44 rotation;
         rotation.rotate(angle);
-        velocity_ = Vector3(0.0, 0.0, Speed0);
+        velocity_ = Vector3(0.0, 0.0, profile.speed0);
         rotation.multiply(&velocity_);
     }
     else
     {
         velocity_ = *opponent->center();
         velocity_.subtract(from);
-        velocity_.normalize(Speed0);
+        velocity_.normalize(profile.speed0);
     }
 
     shooter_ = shooter;
-    target_robo_ = opponent;
+    target_robo_ = is_homing ? opponent : 0;
+    guidance_frames_ = 0;
+    is_off_axis_ = false;
+
+    angle_direction_.set(0.0, 0.0, 0.0); // force to refresh the angle
+    orient();
 }
 
 bool Bullet::did_collide() const { return did_collide_; }
 
-Vector3 Bullet::angle() const
+const Vector3* Bullet::angle() const
 {
     assert(is_owned());
-    Vector3 angle;
-    angle.x = GameLib::atan2(velocity_.z, velocity_.y);
-    angle.y = GameLib::atan2(velocity_.x, velocity_.z);
-    angle.z = GameLib::atan2(velocity_.y, velocity_.x);
-    return angle;
+    return &angle_;
+}
+
+const double* Bullet::basis() const
+{
+    assert(is_owned());
+    return basis_;
 }
 
 void Bullet::burn_at(const Vector3& at)
 {
     did_collide_ = true;
+    current_point_ = at; // stays at the impact point until the next update
 }
 
-void Bullet::draw(const View& view) const
+double Bullet::damage() const
 {
-    if (!is_owned())
-    {
-        return;
-    }
+    assert(is_owned());
+    return profile_->damage;
+}
+
+int Bullet::handle() const { return handle_; }
 
-    GraphicsDatabase::Model* model
-    = TheDatabase::instance().find_model("bullet");
-    model->scale(Scale);
-    model->angle(angle());
-    model->position(current_point_);
-    model->draw_flat_shading(   view.get_perspective_matrix(),
-                                TheEnvironment::Brightness,
-                                TheEnvironment::AmbientBrightness,
-                                TheEnvironment::LightVector);
+const Robo* Bullet::homing_target() const
+{
+    return is_owned() ? target_robo_ : 0;
 }
 
 bool Bullet::is_owned() const { return owner_id_ >= 0; }
 
 bool Bullet::is_owned_by(int id) const { return id == owner_id_; }
 
+int Bullet::owner_id() const { return owner_id_; }
+
 Cuboid Bullet::locus_cuboid() const
 {
     Vector3 half_size;
@@ -163,120 +204,77 @@ Segment Bullet::locus_segment() const
     return Segment(previous_point_, current_point_);
 }
 
+const Vector3* Bullet::point() const { return &current_point_; }
+
+const WeaponProfile* Bullet::profile() const
+{
+    assert(is_owned());
+    return profile_;
+}
+
 namespace
 {
 
 void increase_velocity( Vector3* velocity,
-                        const Vector3& current_angle,
+                        const Vector3& direction,
+                        const WeaponProfile& profile,
                         unsigned age,
                         unsigned dt)
 {
-    double ds = calc_delta_speed(age, dt);
-    Vector3 delta(0.0, 0.0, ds);
-    Matrix44 rotation;
-    rotation.rotate(current_angle);
-    rotation.multiply(&delta);
-    velocity->add(delta);
-}
-
-void fix_horizontal_velocity(   Vector3* velocity,
-                                const Vector3& current_point,
-                                const Vector3& target_point,
-                                double t,
-                                double dt)
-{
-    Vector3 direction(target_point);
-    direction.subtract(current_point);
+    double ds = calc_delta_speed(profile, age, dt);
 
-    double angle_t = GameLib::atan2(direction.x, direction.z);
-    double angle_c = GameLib::atan2(velocity->x, velocity->z);
-    double delta_angle = angle_t - angle_c;
-
-    if (delta_angle > 180.0)
-    {
-        delta_angle = delta_angle - 360.0;
-    }
-    else if (delta_angle <= -180.0)
-    {
-        delta_angle = delta_angle + 360.0;
-    }
-
-    if (delta_angle < -ActiveAngleLimit || delta_angle > ActiveAngleLimit)
+    if (ds == 0.0)
     {
         return;
     }
 
-    const double angle_limit = std::min(    AnglePerMs / t * dt,
-                                            AbsAngleLimit / dt);
-    if (delta_angle > angle_limit)
-    {
-        delta_angle = angle_limit;
-    }
-    else if (delta_angle < -angle_limit)
-    {
-        delta_angle = -angle_limit;
-    }
+    Vector3 delta(direction);
+    delta.multiply(ds);
+    velocity->add(delta);
+}
 
-    Matrix44 rotation;
-    rotation.rotate_zx(delta_angle);
-    rotation.multiply(velocity);
+double wrap_angle(double angle)
+{
+    return  angle > 180.0 ? angle - 360.0
+            : angle <= -180.0 ? angle + 360.0
+            : angle;
 }
 
-void fix_vertical_velocity( Vector3* velocity,
-                            const Vector3& current_point,
-                            const Vector3& target_point,
-                            double t,
-                            double dt)
+double clamp_angle(double angle, double limit)
 {
-    const double diff_y = target_point.y - current_point.y;
-    const double zx_distance = std::sqrt(   std::pow(   target_point.x
-                                                        - current_point.x,
-                                                        2.0)
-                                            + std::pow( target_point.z
-                                                        - current_point.z,
-                                                        2.0));
-    const double zx_velocity = std::sqrt(   std::pow(velocity->x, 2.0)
-                                            + std::pow(velocity->z, 2.0));
-    const double estimated_t = zx_distance / zx_velocity;
-    const double y_at_estimated_t = velocity->y * estimated_t
-                                    - 0.5
-                                    * TheEnvironment::gravity_acceleration()
-                                    * std::pow(estimated_t, 2.0);
-
-    const double speed_limit = std::min(    VerticalAcceleration / t * dt,
-                                            VerticalAbsSpeedLimit / dt);
-
-
-    if (current_point.y + y_at_estimated_t < target_point.y)
-    {
-        velocity->y = velocity->y + speed_limit;
-    }
-    else if (current_point.y + y_at_estimated_t > target_point.y)
+    return angle > limit ? limit : angle < -limit ? -limit : angle;
+}
+
+void atan2_lanes(const double* ys, const double* xs, double* results)
+{
+#if ROBOF_FAST_MATH
+    FastMath::atan2_4(ys, xs, results);
+#else
+    for (int i = 0; i < GuidanceLanes; ++i)
     {
-        velocity->y = velocity->y - speed_limit;
+        results[i] = GameLib::atan2(ys[i], xs[i]);
     }
+#endif
 }
 
-void fix_velocity_cause_of_thruster(    Vector3* velocity,
-                                        const Vector3& current_point,
-                                        const Vector3& target_point,
-                                        double t,
-                                        double dt)
+void sin_cos_lanes(const double* angles, double* sines, double* cosines)
 {
-    fix_horizontal_velocity(    velocity,
-                                current_point,
-                                target_point,
-                                t,
-                                dt);
-    fix_vertical_velocity(  velocity,
-                            current_point,
-                            target_point,
-                            t,
-                            dt);
+#if ROBOF_FAST_MATH
+    FastMath::sin4(angles, sines);
+    FastMath::cos4(angles, cosines);
+#else
+    for (int i = 0; i < GuidanceLanes; ++i)
+    {
+        sines[i] = GameLib::sin(angles[i]);
+        cosines[i] = GameLib::cos(angles[i]);
+    }
+#endif
 }
 
 } // namespace -
 
+// the kind must be the one of the profile, the armoury keeps one pool a kind
+template< int Kind >
 void Bullet::update()
 {
     if (!is_owned())
@@ -284,17 +282,33 @@ void Bullet::update()
         return;
     }
 
+    assert(profile_->kind == Kind);
+
     if (did_collide_)
     {
         clear_owner();
         return;
     }
 
+    if (Traits< Kind >::IsRay)
+    {
+        update_ray();
+        return;
+    }
+
     unsigned dt = TheTime::instance().delta();
-    increase_velocity(&velocity_, angle(), age_, dt);
 
-    velocity_.y = velocity_.y
-    - TheEnvironment::gravity_acceleration() * static_cast< double >(dt) / 1e3;
+    if (Traits< Kind >::HasBoost)
+    {
+        increase_velocity(&velocity_, direction_, *profile_, age_, dt);
+    }
+
+    if (Traits< Kind >::HasGravity)
+    {
+        velocity_.y = velocity_.y
+        - TheEnvironment::gravity_acceleration()
+        * static_cast< double >(dt) / 1e3;
+    }
 
     age_ = age_ + dt;
 
@@ -304,18 +318,158 @@ void Bullet::update()
     previous_point_ = current_point_;
     current_point_.add(delta);
 
-    if (is_homing_)
+    orient();
+
+    if (age_ > profile_->max_age_ms)
     {
-        fix_velocity_cause_of_thruster( &velocity_,
-                                        current_point_,
-                                        *target_robo_->center(),
-                                        static_cast< double >(age_) / 1e3,
-                                        static_cast< double >(dt) / 1e3);
+        clear_owner();
     }
+}
 
-    if (age_ > MaxAgeMs)
+template void Bullet::update< WeaponProfile::KindBallistic >();
+template void Bullet::update< WeaponProfile::KindBoosted >();
+template void Bullet::update< WeaponProfile::KindHoming >();
+template void Bullet::update< WeaponProfile::KindBeam >();
+
+const Vector3* Bullet::velocity() const { return &velocity_; }
+
+// Steers all the homing bullets toward one target, GuidanceLanes at once.
+// Far or off axis bullets are steered every GuidanceLodFrames frames, by
+// the amount of the skipped frames.
+void Bullet::guide( Bullet* const* homings,
+                    size_t size,
+                    const Vector3& target_point)
+{
+    const unsigned dt = TheTime::instance().delta();
+
+    if (dt == 0)
     {
-        clear_owner();
+        return;
+    }
+
+    Bullet* due[GuidanceLanes];
+    int lanes = 0;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        Bullet* bullet = homings[i];
+        bullet->guidance_frames_ = bullet->guidance_frames_ + 1;
+
+        if (!bullet->is_due_for_guidance(target_point))
+        {
+            continue;
+        }
+
+        due[lanes] = bullet;
+        ++lanes;
+
+        if (lanes == GuidanceLanes)
+        {
+            steer(due, lanes, target_point, static_cast< double >(dt) / 1e3);
+            lanes = 0;
+        }
+    }
+
+    if (lanes > 0)
+    {
+        steer(due, lanes, target_point, static_cast< double >(dt) / 1e3);
+    }
+}
+
+void Bullet::steer( Bullet* const* due,
+                    int size,
+                    const Vector3& target_point,
+                    double dt)
+{
+    double to_x[GuidanceLanes];
+    double to_z[GuidanceLanes];
+    double velocity_x[GuidanceLanes];
+    double velocity_z[GuidanceLanes];
+
+    // the unused lanes repeat the first bullet, their results are dropped
+    for (int i = 0; i < GuidanceLanes; ++i)
+    {
+        const Bullet* bullet = due[i < size ? i : 0];
+        to_x[i] = target_point.x - bullet->current_point_.x;
+        to_z[i] = target_point.z - bullet->current_point_.z;
+        velocity_x[i] = bullet->velocity_.x;
+        velocity_z[i] = bullet->velocity_.z;
+    }
+
+    double angle_t[GuidanceLanes];
+    double angle_c[GuidanceLanes];
+    atan2_lanes(to_x, to_z, angle_t);
+    atan2_lanes(velocity_x, velocity_z, angle_c);
+
+    double steered[GuidanceLanes];
+    bool is_off_axis[GuidanceLanes];
+
+    for (int i = 0; i < GuidanceLanes; ++i)
+    {
+        const Bullet* bullet = due[i < size ? i : 0];
+        const WeaponProfile& profile = *bullet->profile_;
+        const double max_age = static_cast< double >(profile.max_age_ms);
+        const double t = static_cast< double >(bullet->age_) / 1e3;
+        const double frames = static_cast< double >(bullet->guidance_frames_);
+        const double delta_angle = wrap_angle(angle_t[i] - angle_c[i]);
+        const double angle_limit
+        = frames * std::min(    AnglePerMs * max_age / t * dt,
+                                profile.abs_angle_limit / dt);
+
+        is_off_axis[i] = delta_angle < -profile.active_angle_limit
+                        || delta_angle > profile.active_angle_limit;
+        steered[i] = is_off_axis[i]
+        ? angle_c[i]
+        : angle_c[i] + clamp_angle(delta_angle, angle_limit);
+    }
+
+    double sines[GuidanceLanes];
+    double cosines[GuidanceLanes];
+    sin_cos_lanes(steered, sines, cosines);
+
+    const double gravity = TheEnvironment::gravity_acceleration();
+
+    for (int i = 0; i < size; ++i)
+    {
+        Bullet* bullet = due[i];
+        Vector3* velocity = &bullet->velocity_;
+        const double max_age
+        = static_cast< double >(bullet->profile_->max_age_ms);
+        const double t = static_cast< double >(bullet->age_) / 1e3;
+        const double frames = static_cast< double >(bullet->guidance_frames_);
+        const double zx_velocity
+        = std::sqrt(    velocity_x[i] * velocity_x[i]
+                        + velocity_z[i] * velocity_z[i]);
+
+        if (!is_off_axis[i])
+        {
+            velocity->x = zx_velocity * sines[i];
+            velocity->z = zx_velocity * cosines[i];
+        }
+
+        const double zx_distance
+        = std::sqrt(to_x[i] * to_x[i] + to_z[i] * to_z[i]);
+        const double estimated_t = zx_distance / zx_velocity;
+        const double y_at_estimated_t
+        = bullet->current_point_.y
+        + velocity->y * estimated_t
+        - 0.5 * gravity * estimated_t * estimated_t;
+        const double speed_limit
+        = frames * std::min(    VerticalAcceleration * max_age / t * dt,
+                                VerticalAbsSpeedLimit / dt);
+
+        if (y_at_estimated_t < target_point.y)
+        {
+            velocity->y = velocity->y + speed_limit;
+        }
+        else if (y_at_estimated_t > target_point.y)
+        {
+            velocity->y = velocity->y - speed_limit;
+        }
+
+        bullet->is_off_axis_ = is_off_axis[i];
+        bullet->guidance_frames_ = 0;
+        bullet->orient();
     }
 }
 
@@ -325,3 +479,77 @@ void Bullet::clear_owner()
     target_robo_ = 0;
     did_collide_ = false;
 }
+
+bool Bullet::is_due_for_guidance(const Vector3& target_point) const
+{
+    if (!DoesUseGuidanceLod || guidance_frames_ >= GuidanceLodFrames)
+    {
+        return true;
+    }
+
+    if (is_off_axis_)
+    {
+        return false;
+    }
+
+    Vector3 to_target(target_point);
+    to_target.subtract(current_point_);
+
+    return to_target.squared_length()
+    <= GuidanceLodDistance * GuidanceLodDistance;
+}
+
+// The whole range in the first update, so the collision passes test it as a
+// ray and the hit queue keeps the earliest impact on it.  Gone by the next.
+void Bullet::update_ray()
+{
+    if (age_ > 0)
+    {
+        clear_owner();
+        return;
+    }
+
+    Vector3 delta(direction_);
+    delta.multiply(profile_->range());
+
+    previous_point_ = current_point_;
+    current_point_.add(delta);
+    age_ = std::max(profile_->max_age_ms, 1u);
+}
+
+// the angle is only for the model, so refresh it when it turns visibly
+void Bullet::orient()
+{
+    const double speed = velocity_.length();
+
+    if (speed == 0.0)
+    {
+        return;
+    }
+
+    direction_ = velocity_;
+    direction_.divide(speed);
+
+    if (direction_.dot(angle_direction_) > AngleRefreshCosine)
+    {
+        return;
+    }
+
+    angle_.x = Trigonometry::atan2(velocity_.z, velocity_.y);
+    angle_.y = Trigonometry::atan2(velocity_.x, velocity_.z);
+    angle_.z = Trigonometry::atan2(velocity_.y, velocity_.x);
+    angle_direction_ = direction_;
+
+    Matrix44 rotation;
+    rotation.rotate(angle_);
+    double rows[4][4];
+    BatchTransform::get_rows(rotation, rows);
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int column = 0; column < 3; ++column)
+        {
+            basis_[row * 3 + column] = rows[row][column];
+        }
+    }
+}
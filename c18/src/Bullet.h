@@ -1,11 +1,12 @@
 #ifndef ROBOFBULLET_H_
 #define ROBOFBULLET_H_
+#include <cstddef>
 #include "GraphicsDatabase/Vector3.h"
 
 class Cuboid;
 class Robo;
 class Segment;
-class View;
+class WeaponProfile;
 
 using GraphicsDatabase::Vector3;
 
@@ -13,36 +14,64 @@ class Bullet
 {
 private:
     int owner_id_;
+    int handle_;
     unsigned age_;
-    bool is_homing_;
+    const WeaponProfile* profile_;
     bool did_collide_;
     Vector3 previous_point_;
     Vector3 current_point_;
     Vector3 velocity_;
+    Vector3 direction_;
+    Vector3 angle_;
+    Vector3 angle_direction_;
+    double basis_[9]; // the rotation of the angle, 3 rows
     const Robo* shooter_;
     const Robo* target_robo_;
+    unsigned guidance_frames_;
+    bool is_off_axis_;
+
+public:
+    static void guide(  Bullet* const* homings,
+                        size_t size,
+                        const Vector3& target_point);
 
 public:
     Bullet();
     ~Bullet();
     void initialize(    int id,
+                        int handle,
+                        const WeaponProfile& profile,
                         const Vector3& from,
                         const Vector3& angle,
                         const Robo* shooter,
-                        const Robo* opponent,
-                        bool is_homing);
+                        const Robo* opponent);
     bool did_collide() const;
-    Vector3 angle() const;
+    const Vector3* angle() const;
+    const double* basis() const; // refreshed with the angle
     void burn_at(const Vector3& at);
-    void draw(const View& view) const;
+    double damage() const;
+    int handle() const; // in TheArmoury, kept while the slot moves
+    const Robo* homing_target() const;
     bool is_owned() const;
     bool is_owned_by(int id) const;
+    int owner_id() const;
     Cuboid locus_cuboid() const;
     Segment locus_segment() const;
+    const Vector3* point() const;
+    const WeaponProfile* profile() const;
+    template< int Kind >
     void update();
+    const Vector3* velocity() const;
 
 private:
+    static void steer( Bullet* const* due,
+                        int size,
+                        const Vector3& target_point,
+                        double dt);
     void clear_owner();
+    bool is_due_for_guidance(const Vector3& target_point) const;
+    void orient();
+    void update_ray();
 };
 
 #endif
@@ -0,0 +1,345 @@
+#include "BulletRenderer.h"
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <vector>
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Model.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "Frustum.h"
+#include "Platform.h"
+#include "TheDatabase.h"
+#include "TheDrawQueue.h"
+#include "TheEnvironment.h"
+#include "View.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Model;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const double Scale = 0.2;
+const size_t ReservedInstances = 2000;
+const double ProxyDistance = 20.0; // [m]
+const double ImpostorDistance = 50.0; // [m]
+const double ImpostorPixels = 1.5; // the half size
+
+// a pyramid on the bottom of the box of the mesh, 4 faces
+const int ProxyIndexes[] = { 0, 1, 2, 0, 2, 3, 0, 3, 1, 1, 3, 2 };
+
+// as the flat shading of the model, a color a face
+unsigned get_color(const Vector3& normal)
+{
+    const double length = normal.length();
+    const double diffuse
+    = length > 0.0
+    ? std::max(0.0, normal.dot(TheEnvironment::LightVector) / length)
+    : 0.0;
+
+    const Vector3& brightness = TheEnvironment::Brightness;
+    const double ambient = TheEnvironment::AmbientBrightness;
+    const unsigned red = static_cast< unsigned >(
+        255.0 * std::min(1.0, ambient + brightness.x * diffuse));
+    const unsigned green = static_cast< unsigned >(
+        255.0 * std::min(1.0, ambient + brightness.y * diffuse));
+    const unsigned blue = static_cast< unsigned >(
+        255.0 * std::min(1.0, ambient + brightness.z * diffuse));
+
+    return 0xff000000 | red << 16 | green << 8 | blue;
+}
+
+unsigned get_color(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+    Vector3 normal(p1);
+    normal.subtract(p0);
+    Vector3 edge(p2);
+    edge.subtract(p0);
+    normal.cross_product(edge);
+    return get_color(normal);
+}
+
+} // namespace -
+
+BulletRenderer::BulletRenderer()
+:   proxy_distance_(ProxyDistance),
+    impostor_distance_(ImpostorDistance),
+    impostor_color_(get_color(TheEnvironment::LightVector)),
+    bounding_radius_(0.0),
+    xs_(), ys_(), zs_(), radii_(), visibles_(), bases_(),
+    world_(), vertexes_(), colors_()
+{
+    const Model* model = TheDatabase::instance().find_model("bullet");
+    const Vector3* vertexes = model->vertexes();
+    const int* indexes = model->indexes();
+    Mesh* mesh = &meshes_[LodMesh];
+
+    for (size_t i = 0; i < model->vertexes_size(); ++i)
+    {
+        Vector3 vertex(vertexes[i]);
+        vertex.multiply(Scale);
+        mesh->vertexes.push_back(vertex);
+    }
+
+    mesh->indexes.assign(indexes, indexes + model->indexes_size());
+
+    Vector3 min(mesh->vertexes.at(0));
+    Vector3 max(min);
+    bounding_radius_ = min.length();
+
+    for (size_t i = 1; i < mesh->vertexes.size(); ++i)
+    {
+        const Vector3& vertex = mesh->vertexes.at(i);
+        min.set(    std::min(min.x, vertex.x),
+                    std::min(min.y, vertex.y),
+                    std::min(min.z, vertex.z));
+        max.set(    std::max(max.x, vertex.x),
+                    std::max(max.y, vertex.y),
+                    std::max(max.z, vertex.z));
+        bounding_radius_
+        = std::max(bounding_radius_, vertex.length());
+    }
+
+    Mesh* proxy = &meshes_[LodProxy];
+    proxy->vertexes.push_back(Vector3(0.0, max.y, 0.0));
+    proxy->vertexes.push_back(Vector3(min.x, min.y, min.z));
+    proxy->vertexes.push_back(Vector3(max.x, min.y, min.z));
+    proxy->vertexes.push_back(Vector3(0.0, min.y, max.z));
+    proxy->indexes.assign(
+        ProxyIndexes,
+        ProxyIndexes + sizeof(ProxyIndexes) / sizeof(ProxyIndexes[0]));
+
+    world_.resize(mesh->vertexes.size());
+    xs_.reserve(ReservedInstances);
+    ys_.reserve(ReservedInstances);
+    zs_.reserve(ReservedInstances);
+    radii_.reserve(ReservedInstances);
+    visibles_.reserve(ReservedInstances);
+    bases_.reserve(ReservedInstances * 9);
+    vertexes_.reserve(ReservedInstances * mesh->indexes.size());
+    colors_.reserve(ReservedInstances * mesh->indexes.size() / 3);
+
+    for (int i = 0; i < LodSize; ++i)
+    {
+        triangle_counts_[i] = 0;
+    }
+}
+
+BulletRenderer::~BulletRenderer() {}
+
+void BulletRenderer::add(const Vector3& point, const double* basis)
+{
+    xs_.push_back(point.x);
+    ys_.push_back(point.y);
+    zs_.push_back(point.z);
+    radii_.push_back(bounding_radius_);
+    bases_.insert(bases_.end(), basis, basis + 9);
+}
+
+void BulletRenderer::clear()
+{
+    xs_.clear();
+    ys_.clear();
+    zs_.clear();
+    radii_.clear();
+    bases_.clear();
+}
+
+void BulletRenderer::draw(const View& view)
+{
+    cull(view);
+    transform(view);
+
+    TheDrawQueue queue = TheDrawQueue::instance();
+    queue.texture(0);
+
+    for (size_t i = 0; i < vertexes_.size(); i = i + 3)
+    {
+        const unsigned color = colors_.at(i / 3);
+        queue.add_triangle(  &vertexes_.at(i).x,
+                             &vertexes_.at(i + 1).x,
+                             &vertexes_.at(i + 2).x,
+                             0, 0, 0,
+                             color, color, color);
+    }
+}
+
+void BulletRenderer::lod_distances( double proxy_distance,
+                                    double impostor_distance)
+{
+    assert(proxy_distance <= impostor_distance);
+    proxy_distance_ = proxy_distance;
+    impostor_distance_ = impostor_distance;
+}
+
+void BulletRenderer::print(std::ostringstream* oss) const
+{
+    *oss << "bullet triangles: ";
+    *oss << triangle_counts_[LodMesh];
+    *oss << " mesh, ";
+    *oss << triangle_counts_[LodProxy];
+    *oss << " proxy, ";
+    *oss << triangle_counts_[LodImpostor];
+    *oss << " impostor";
+}
+
+// in the clip space already, a constant size on the screen; the halves are
+// of the clip space, so they differ by the aspect for square pixels
+void BulletRenderer::add_impostor(  const Matrix44& perspective,
+                                    const Vector3& point,
+                                    double half_width,
+                                    double half_height)
+{
+    Vector3 center(point);
+    center.w = 1.0;
+    perspective.multiply(&center);
+
+    const double dx = half_width * center.w;
+    const double dy = half_height * center.w;
+    Vector3 corners[4] = { center, center, center, center };
+    corners[0].x = center.x - dx;
+    corners[0].y = center.y + dy;
+    corners[1].x = center.x + dx;
+    corners[1].y = center.y + dy;
+    corners[2].x = center.x - dx;
+    corners[2].y = center.y - dy;
+    corners[3].x = center.x + dx;
+    corners[3].y = center.y - dy;
+
+    vertexes_.push_back(corners[0]);
+    vertexes_.push_back(corners[1]);
+    vertexes_.push_back(corners[2]);
+    vertexes_.push_back(corners[3]);
+    vertexes_.push_back(corners[1]);
+    vertexes_.push_back(corners[2]);
+    colors_.push_back(impostor_color_);
+    colors_.push_back(impostor_color_);
+}
+
+// in the world space, to the clip space in transform; the basis is kept by
+// the bullet, so no matrix is built here
+void BulletRenderer::add_mesh(  const Mesh& mesh,
+                                const Vector3& point,
+                                const double* basis)
+{
+    for (size_t j = 0; j < mesh.vertexes.size(); ++j)
+    {
+        const Vector3& vertex = mesh.vertexes.at(j);
+        Vector3& world = world_.at(j);
+        world.x = basis[0] * vertex.x + basis[1] * vertex.y
+                + basis[2] * vertex.z + point.x;
+        world.y = basis[3] * vertex.x + basis[4] * vertex.y
+                + basis[5] * vertex.z + point.y;
+        world.z = basis[6] * vertex.x + basis[7] * vertex.y
+                + basis[8] * vertex.z + point.z;
+        world.w = 1.0;
+    }
+
+    for (size_t j = 0; j < mesh.indexes.size(); j = j + 3)
+    {
+        const Vector3& p0 = world_.at(mesh.indexes.at(j));
+        const Vector3& p1 = world_.at(mesh.indexes.at(j + 1));
+        const Vector3& p2 = world_.at(mesh.indexes.at(j + 2));
+        colors_.push_back(get_color(p0, p1, p2));
+        vertexes_.push_back(p0);
+        vertexes_.push_back(p1);
+        vertexes_.push_back(p2);
+    }
+}
+
+// all the bounding spheres in one batch, before any transform
+void BulletRenderer::cull(const View& view)
+{
+    visibles_.resize(xs_.size());
+
+    if (xs_.empty())
+    {
+        return;
+    }
+
+    view.frustum()->cull(   &xs_.at(0),
+                            &ys_.at(0),
+                            &zs_.at(0),
+                            &radii_.at(0),
+                            static_cast< int >(xs_.size()),
+                            &visibles_.at(0));
+}
+
+// every visible face to the clip space, with its color
+void BulletRenderer::transform(const View& view)
+{
+    const Matrix44 perspective(view.get_perspective_matrix());
+    const Vector3& eye = *view.center();
+    const double proxy2 = proxy_distance_ * proxy_distance_;
+    const double impostor2 = impostor_distance_ * impostor_distance_;
+    const double half_width
+    = ImpostorPixels * 2.0
+    / static_cast< double >(Platform::width());
+    const double half_height
+    = ImpostorPixels * 2.0
+    / static_cast< double >(Platform::height());
+
+    vertexes_.clear();
+    colors_.clear();
+
+    // the meshes first, the impostors after them are projected already
+    int instance_counts[LodSize] = { 0, 0, 0 };
+
+    for (size_t i = 0; i < xs_.size(); ++i)
+    {
+        if (!visibles_.at(i))
+        {
+            continue;
+        }
+
+        const Vector3 point(xs_.at(i), ys_.at(i), zs_.at(i));
+        Vector3 to_eye(point);
+        to_eye.subtract(eye);
+        const double distance2 = to_eye.squared_length();
+
+        if (distance2 >= impostor2)
+        {
+            continue;
+        }
+
+        const Lod lod = distance2 >= proxy2 ? LodProxy : LodMesh;
+        add_mesh(meshes_[lod], point, &bases_.at(i * 9));
+        ++instance_counts[lod];
+    }
+
+    const size_t mesh_vertexes_size = vertexes_.size();
+
+    for (size_t i = 0; i < mesh_vertexes_size; ++i)
+    {
+        perspective.multiply(&vertexes_.at(i));
+    }
+
+    for (size_t i = 0; i < xs_.size(); ++i)
+    {
+        if (!visibles_.at(i))
+        {
+            continue;
+        }
+
+        const Vector3 point(xs_.at(i), ys_.at(i), zs_.at(i));
+        Vector3 to_eye(point);
+        to_eye.subtract(eye);
+
+        if (to_eye.squared_length() < impostor2)
+        {
+            continue;
+        }
+
+        add_impostor(perspective, point, half_width, half_height);
+        ++instance_counts[LodImpostor];
+    }
+
+    triangle_counts_[LodMesh]
+    = instance_counts[LodMesh]
+    * static_cast< int >(meshes_[LodMesh].indexes.size() / 3);
+    triangle_counts_[LodProxy]
+    = instance_counts[LodProxy]
+    * static_cast< int >(meshes_[LodProxy].indexes.size() / 3);
+    triangle_counts_[LodImpostor] = 2 * instance_counts[LodImpostor];
+}
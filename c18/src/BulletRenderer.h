@@ -0,0 +1,72 @@
+#ifndef ROBOFBULLETRENDERER_H_
+#define ROBOFBULLETRENDERER_H_
+#include <sstream>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+
+namespace GraphicsDatabase { class Matrix44; }
+class View;
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+// Draws all the bullets of a frame as one stream of the triangles.  The mesh
+// is copied from the "bullet" model once; the instances are added, then
+// transformed in one pass and drawn in one run.  By the distance from the
+// view, a bullet is the mesh, a low poly proxy of it, or a camera facing
+// quad of a few pixels.
+class BulletRenderer
+{
+public:
+    enum Lod
+    {
+        LodMesh,
+        LodProxy,
+        LodImpostor,
+        LodSize,
+    };
+
+private:
+    struct Mesh
+    {
+        std::vector< Vector3 > vertexes;
+        std::vector< int > indexes;
+    };
+
+private:
+    Mesh meshes_[LodImpostor];
+    double proxy_distance_;
+    double impostor_distance_;
+    unsigned impostor_color_;
+    double bounding_radius_;
+    std::vector< double > xs_;
+    std::vector< double > ys_;
+    std::vector< double > zs_;
+    std::vector< double > radii_;
+    std::vector< int > visibles_;
+    std::vector< double > bases_; // 9 an instance
+    std::vector< Vector3 > world_; // of an instance
+    std::vector< Vector3 > vertexes_;
+    std::vector< unsigned > colors_;
+    int triangle_counts_[LodSize];
+
+public:
+    BulletRenderer();
+    ~BulletRenderer();
+    void add(const Vector3& point, const double* basis); // 3 rows of 3
+    void clear();
+    void draw(const View& view);
+    void lod_distances(double proxy_distance, double impostor_distance);
+    void print(std::ostringstream* oss) const;
+
+private:
+    void add_impostor(  const Matrix44& perspective,
+                        const Vector3& point,
+                        double half_width,
+                        double half_height);
+    void add_mesh(const Mesh& mesh, const Vector3& point, const double* basis);
+    void cull(const View& view);
+    void transform(const View& view);
+};
+
+#endif
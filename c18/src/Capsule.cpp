@@ -0,0 +1,157 @@
+#include "Capsule.h"
+#include <cmath>
+#include "GraphicsDatabase/Vector3.h"
+#include "Segment.h"
+#include "Triangle.h"
+
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const double ContactSkin    = 1e-3; // [m]
+const int MaxAdvancement    = 32;
+
+} // namespace -
+
+Capsule::Capsule()
+: from_(), to_(), r_(0.0)
+{}
+
+Capsule::Capsule(const Vector3& from, const Vector3& to, double radius)
+: from_(from), to_(to), r_(radius)
+{}
+
+Capsule::~Capsule() {}
+
+const Vector3* Capsule::from() const { return &from_; }
+
+const Vector3* Capsule::to() const { return &to_; }
+
+double Capsule::radius() const { return r_; }
+
+namespace
+{
+
+Segment moved_axis( const Vector3& from,
+                    const Vector3& to,
+                    const Vector3& delta,
+                    double t)
+{
+    Vector3 d(delta);
+    d.multiply(t);
+    Vector3 p0(from);
+    p0.add(d);
+    Vector3 p1(to);
+    p1.add(d);
+    return Segment(p0, p1);
+}
+
+// Conservative advancement: the gap can not shrink faster than |delta| per
+// unit t, so stepping t by gap / |delta| never jumps over a contact.  The
+// gap of two convex shapes is convex along a linear motion, so once it
+// stops shrinking there is no hit at all.
+template< class T >
+bool advance(   const Vector3& from,
+                const Vector3& to,
+                double radius,
+                const Vector3& delta,
+                const T& other,
+                const Vector3& fallback_normal,
+                double* t,
+                Vector3* normal)
+{
+    const double speed = delta.length();
+
+    if (speed == 0.0)
+    {
+        return false;
+    }
+
+    double s = 0.0;
+    Vector3 on_axis;
+    Vector3 on_other;
+
+    for (int i = 0; i < MaxAdvancement; ++i)
+    {
+        const Segment axis = moved_axis(from, to, delta, s);
+        const double distance
+        = std::sqrt(axis.get_squared_distance(other, &on_axis, &on_other));
+        const double gap = distance - radius;
+
+        if (distance > 0.0)
+        {
+            *normal = on_axis;
+            normal->subtract(on_other);
+            normal->divide(distance);
+        }
+        else
+        {
+            *normal = fallback_normal;
+        }
+
+        if (gap < ContactSkin)
+        {
+            if (delta.dot(*normal) >= 0.0)
+            {
+                return false; // separating or sliding along
+            }
+
+            *t = s;
+            return true;
+        }
+
+        s = s + (gap - ContactSkin * 0.5) / speed;
+
+        if (s > 1.0)
+        {
+            return false;
+        }
+    }
+
+    // still closing in, stop here rather than risk going through
+    *t = s;
+    return delta.dot(*normal) < 0.0;
+}
+
+} // namespace -
+
+bool Capsule::sweep(    const Vector3& delta,
+                        const Capsule& other,
+                        double* t,
+                        Vector3* normal) const
+{
+    const Segment other_axis(other.from_, other.to_);
+    Vector3 fallback_normal(delta);
+    fallback_normal.normalize(-1.0);
+    return advance( from_,
+                    to_,
+                    r_ + other.r_,
+                    delta,
+                    other_axis,
+                    fallback_normal,
+                    t,
+                    normal);
+}
+
+bool Capsule::sweep(    const Vector3& delta,
+                        const Triangle& triangle,
+                        double* t,
+                        Vector3* normal) const
+{
+    Vector3 fallback_normal(triangle.normal());
+
+    if (fallback_normal.dot(delta) > 0.0)
+    {
+        fallback_normal.multiply(-1.0);
+    }
+
+    return advance( from_,
+                    to_,
+                    r_,
+                    delta,
+                    triangle,
+                    fallback_normal,
+                    t,
+                    normal);
+}
@@ -0,0 +1,33 @@
+#ifndef ROBOFCAPSULE_H_
+#define ROBOFCAPSULE_H_
+#include "GraphicsDatabase/Vector3.h"
+
+class Triangle;
+
+using GraphicsDatabase::Vector3;
+
+class Capsule
+{
+private:
+    Vector3 from_;
+    Vector3 to_;
+    double r_;
+
+public:
+    Capsule();
+    Capsule(const Vector3& from, const Vector3& to, double radius);
+    ~Capsule();
+    const Vector3* from() const;
+    const Vector3* to() const;
+    double radius() const;
+    bool sweep( const Vector3& delta,
+                const Capsule& other,
+                double* t,
+                Vector3* normal) const;
+    bool sweep( const Vector3& delta,
+                const Triangle& triangle,
+                double* t,
+                Vector3* normal) const;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "DataTree.h"
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Tokenizer.h"
+
+void DataTree::load(const std::string& filename, DataTree* tree)
+{
+    std::ifstream file(filename.c_str());
+    assert(file);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    const std::string text = oss.str();
+
+    Tokenizer tokenizer(text);
+    tree->nodes_.clear();
+    tree->parse(tokenizer.next(), &tokenizer);
+}
+
+DataTree::DataTree()
+: nodes_()
+{}
+
+DataTree::~DataTree() {}
+
+int DataTree::at(int node, int i) const
+{
+    return nodes_.at(node).children.at(i);
+}
+
+int DataTree::find(int node, const std::string& key) const
+{
+    const Node& object = nodes_.at(node);
+
+    for (size_t i = 0; i < object.keys.size(); ++i)
+    {
+        if (object.keys.at(i) == key)
+        {
+            return object.children.at(i);
+        }
+    }
+
+    return -1;
+}
+
+double DataTree::number(int node) const
+{
+    assert(nodes_.at(node).type == TypeNumber);
+    return nodes_.at(node).number;
+}
+
+int DataTree::root() const
+{
+    assert(!nodes_.empty());
+    return 0;
+}
+
+int DataTree::size(int node) const
+{
+    return static_cast< int >(nodes_.at(node).children.size());
+}
+
+const std::string& DataTree::string(int node) const
+{
+    return nodes_.at(node).string;
+}
+
+DataTree::Type DataTree::type(int node) const
+{
+    return nodes_.at(node).type;
+}
+
+// The node is pushed before its children, so the root is at 0.  The
+// children are kept in locals until the node is done, as the push backs
+// move the nodes.
+int DataTree::parse(const std::string& first, Tokenizer* tokenizer)
+{
+    assert(!first.empty());
+    const int index = static_cast< int >(nodes_.size());
+    nodes_.push_back(Node());
+
+    if (first != "{" && first != "[")
+    {
+        const bool is_quoted = first.at(0) == '"';
+        const char c = first.at(0);
+        const bool is_number
+        = !is_quoted
+        && (std::isdigit(static_cast< unsigned char >(c))
+            || c == '-' || c == '+' || c == '.');
+        Node& node = nodes_.back();
+        node.type = is_number ? TypeNumber : TypeString;
+        node.number = is_number ? std::atof(first.c_str()) : 0.0;
+        node.string
+        = is_quoted ? first.substr(1, first.size() - 2) : first;
+        return index;
+    }
+
+    const bool is_object = first == "{";
+    const std::string close = is_object ? "}" : "]";
+    std::vector< std::string > keys;
+    std::vector< int > children;
+
+    for (   std::string token = tokenizer->next();
+            token != close;
+            token = tokenizer->next())
+    {
+        if (token == ",")
+        {
+            continue;
+        }
+
+        if (is_object)
+        {
+            keys.push_back(token.at(0) == '"'
+                            ? token.substr(1, token.size() - 2)
+                            : token);
+            token = tokenizer->next();
+            assert(token == ":");
+            token = tokenizer->next();
+        }
+
+        children.push_back(parse(token, tokenizer));
+    }
+
+    Node& node = nodes_.at(index);
+    node.type = is_object ? TypeObject : TypeArray;
+    node.keys.swap(keys);
+    node.children.swap(children);
+    return index;
+}
@@ -0,0 +1,53 @@
+#ifndef ROBOFDATATREE_H_
+#define ROBOFDATATREE_H_
+#include <string>
+#include <vector>
+
+class Tokenizer;
+
+// A whole pseudo json file, read by the Tokenizer.  The values are nodes
+// of one array, the root at 0, and refer to their children by the index.
+// Bare words other than numbers, such as true, are strings.
+class DataTree
+{
+public:
+    enum Type
+    {
+        TypeNumber,
+        TypeString,
+        TypeArray,
+        TypeObject
+    };
+
+private:
+    struct Node
+    {
+        Type type;
+        double number;
+        std::string string; // unquoted
+        std::vector< std::string > keys; // of an object
+        std::vector< int > children;
+    };
+
+private:
+    std::vector< Node > nodes_;
+
+public:
+    static void load(const std::string& filename, DataTree* tree);
+
+public:
+    DataTree();
+    ~DataTree();
+    int at(int node, int i) const;
+    int find(int node, const std::string& key) const; // -1 if none
+    double number(int node) const;
+    int root() const;
+    int size(int node) const;
+    const std::string& string(int node) const;
+    Type type(int node) const;
+
+private:
+    int parse(const std::string& first, Tokenizer* tokenizer);
+};
+
+#endif
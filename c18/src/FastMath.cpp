@@ -0,0 +1,143 @@
+#include "FastMath.h"
+#include <cmath>
+
+namespace
+{
+
+const double Pi         = 3.14159265358979323846;
+const double RadPerDeg  = Pi / 180.0;
+const double DegPerRad  = 180.0 / Pi;
+const double TanPiPer8  = 0.41421356237309504880;
+
+// sin(x) for |x| <= pi / 2, taylor up to x^15
+inline double sin_kernel(double x)
+{
+    const double x2 = x * x;
+    double p = -1.0 / 1307674368000.0;
+    p = p * x2 + 1.0 / 6227020800.0;
+    p = p * x2 - 1.0 / 39916800.0;
+    p = p * x2 + 1.0 / 362880.0;
+    p = p * x2 - 1.0 / 5040.0;
+    p = p * x2 + 1.0 / 120.0;
+    p = p * x2 - 1.0 / 6.0;
+    p = p * x2 + 1.0;
+    return p * x;
+}
+
+// atan(z) for |z| <= tan(pi / 8), taylor up to z^15
+inline double atan_kernel(double z)
+{
+    const double z2 = z * z;
+    double p = -1.0 / 15.0;
+    p = p * z2 + 1.0 / 13.0;
+    p = p * z2 - 1.0 / 11.0;
+    p = p * z2 + 1.0 / 9.0;
+    p = p * z2 - 1.0 / 7.0;
+    p = p * z2 + 1.0 / 5.0;
+    p = p * z2 - 1.0 / 3.0;
+    p = p * z2 + 1.0;
+    return p * z;
+}
+
+inline double sin_degree(double degree)
+{
+    // to turns in [-0.5, 0.5], then fold into [-0.25, 0.25]
+    double turn = degree / 360.0;
+    turn = turn - std::floor(turn + 0.5);
+    turn = turn > 0.25 ? 0.5 - turn : turn;
+    turn = turn < -0.25 ? -0.5 - turn : turn;
+    return sin_kernel(turn * 2.0 * Pi);
+}
+
+inline double atan2_degree(double y, double x)
+{
+    const double abs_y = std::abs(y);
+    const double abs_x = std::abs(x);
+    const double max = abs_y > abs_x ? abs_y : abs_x;
+    const double min = abs_y > abs_x ? abs_x : abs_y;
+    const double a = max == 0.0 ? 0.0 : min / max; // [0, 1]
+
+    // atan(a) = pi / 4 + atan((a - 1) / (a + 1))
+    const bool is_far = a > TanPiPer8;
+    const double z = is_far ? (a - 1.0) / (a + 1.0) : a;
+    double r = atan_kernel(z) * DegPerRad + (is_far ? 45.0 : 0.0);
+
+    r = abs_y > abs_x ? 90.0 - r : r;
+    r = x < 0.0 ? 180.0 - r : r;
+    return y < 0.0 ? -r : r;
+}
+
+template< int N >
+void sin_n(const double* degrees, double* results)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        results[i] = sin_degree(degrees[i]);
+    }
+}
+
+template< int N >
+void cos_n(const double* degrees, double* results)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        results[i] = sin_degree(degrees[i] + 90.0);
+    }
+}
+
+template< int N >
+void atan2_n(const double* ys, const double* xs, double* results)
+{
+    for (int i = 0; i < N; ++i)
+    {
+        results[i] = atan2_degree(ys[i], xs[i]);
+    }
+}
+
+} // namespace -
+
+namespace FastMath
+{
+
+double sin(double degree) { return sin_degree(degree); }
+
+double cos(double degree) { return sin_degree(degree + 90.0); }
+
+double tan(double degree)
+{
+    return sin_degree(degree) / sin_degree(degree + 90.0);
+}
+
+double atan2(double y, double x) { return atan2_degree(y, x); }
+
+void sin4(const double* degrees, double* results)
+{
+    sin_n< 4 >(degrees, results);
+}
+
+void cos4(const double* degrees, double* results)
+{
+    cos_n< 4 >(degrees, results);
+}
+
+void atan2_4(const double* ys, const double* xs, double* results)
+{
+    atan2_n< 4 >(ys, xs, results);
+}
+
+void sin8(const double* degrees, double* results)
+{
+    sin_n< 8 >(degrees, results);
+}
+
+void cos8(const double* degrees, double* results)
+{
+    cos_n< 8 >(degrees, results);
+}
+
+void atan2_8(const double* ys, const double* xs, double* results)
+{
+    atan2_n< 8 >(ys, xs, results);
+}
+
+} // namespace FastMath
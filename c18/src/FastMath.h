@@ -0,0 +1,38 @@
+#ifndef ROBOFFASTMATH_H_
+#define ROBOFFASTMATH_H_
+
+// Trigonometry in degrees like GameLib/Math.h, by polynomials.
+// Absolute error: sin, cos < 1e-10, atan2 < 1e-6 [degree], tan follows cos.
+// The 4 and 8 lane versions are branch free loops over the lanes, they
+// are left to the auto vectorizer.
+namespace FastMath
+{
+
+double sin(double degree);
+double cos(double degree);
+double tan(double degree);
+double atan2(double y, double x);
+
+void sin4(const double* degrees, double* results);
+void cos4(const double* degrees, double* results);
+void atan2_4(const double* ys, const double* xs, double* results);
+
+void sin8(const double* degrees, double* results);
+void cos8(const double* degrees, double* results);
+void atan2_8(const double* ys, const double* xs, double* results);
+
+} // namespace FastMath
+
+// 1 to steer bullets and lock on by FastMath, 0 to do by GameLib
+#ifndef ROBOF_FAST_MATH
+#define ROBOF_FAST_MATH 1
+#endif
+
+#if ROBOF_FAST_MATH
+namespace Trigonometry = FastMath;
+#else
+#include "GameLib/Math.h"
+namespace Trigonometry = GameLib;
+#endif
+
+#endif
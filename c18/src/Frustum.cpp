@@ -0,0 +1,125 @@
+#include "Frustum.h"
+#include <cmath>
+#include <sstream>
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "BatchTransform.h"
+#include "Sphere.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+Frustum::Frustum()
+: culled_count_(0), drawn_count_(0)
+{
+    // contains everything
+    for (int i = 0; i < PlaneSize; ++i)
+    {
+        normal_xs_[i] = 0.0;
+        normal_ys_[i] = 0.0;
+        normal_zs_[i] = 0.0;
+        distances_[i] = 1.0;
+    }
+}
+
+// A plane is the w row of the matrix plus or minus another row.  The near
+// one is -w < z, wider than 0 < z, so it never culls a visible one.
+Frustum::Frustum(const Matrix44& perspective)
+: culled_count_(0), drawn_count_(0)
+{
+    double rows[4][4];
+    BatchTransform::get_rows(perspective, rows);
+
+    for (int i = 0; i < PlaneSize; ++i)
+    {
+        const double* other = rows[i / 2];
+        const double sign = i % 2 == 0 ? 1.0 : -1.0;
+        const double a = rows[3][0] + sign * other[0];
+        const double b = rows[3][1] + sign * other[1];
+        const double c = rows[3][2] + sign * other[2];
+        const double d = rows[3][3] + sign * other[3];
+        const double length = std::sqrt(a * a + b * b + c * c);
+        const double scale = length > 0.0 ? 1.0 / length : 0.0;
+
+        normal_xs_[i] = a * scale;
+        normal_ys_[i] = b * scale;
+        normal_zs_[i] = c * scale;
+        distances_[i] = d * scale;
+    }
+}
+
+Frustum::~Frustum() {}
+
+bool Frustum::contains(const Sphere& sphere) const
+{
+    int visible = 0;
+    const Vector3* balance = sphere.balance();
+    const double radius = sphere.radius();
+    cull(&balance->x, &balance->y, &balance->z, &radius, 1, &visible);
+    return visible != 0;
+}
+
+// Lanes spheres at once against all the planes, with no branch in a group,
+// so the compiler can vectorize it.  Returns the count of the visible ones.
+int Frustum::cull(  const double* xs,
+                    const double* ys,
+                    const double* zs,
+                    const double* radii,
+                    int size,
+                    int* visibles) const
+{
+    int visible_count = 0;
+
+    for (int begin = 0; begin < size; begin = begin + Lanes)
+    {
+        const int lanes = size - begin < Lanes ? size - begin : Lanes;
+        double x[Lanes];
+        double y[Lanes];
+        double z[Lanes];
+        double r[Lanes];
+        int inside[Lanes];
+
+        // the unused lanes repeat the first sphere, their results are dropped
+        for (int i = 0; i < Lanes; ++i)
+        {
+            const int k = begin + (i < lanes ? i : 0);
+            x[i] = xs[k];
+            y[i] = ys[k];
+            z[i] = zs[k];
+            r[i] = radii[k];
+            inside[i] = 1;
+        }
+
+        for (int plane = 0; plane < PlaneSize; ++plane)
+        {
+            for (int i = 0; i < Lanes; ++i)
+            {
+                const double distance
+                = normal_xs_[plane] * x[i]
+                + normal_ys_[plane] * y[i]
+                + normal_zs_[plane] * z[i]
+                + distances_[plane];
+                inside[i] = inside[i] & (distance >= -r[i]);
+            }
+        }
+
+        for (int i = 0; i < lanes; ++i)
+        {
+            visibles[begin + i] = inside[i];
+            visible_count = visible_count + inside[i];
+        }
+    }
+
+    drawn_count_ = drawn_count_ + visible_count;
+    culled_count_ = culled_count_ + size - visible_count;
+
+    return visible_count;
+}
+
+void Frustum::print(std::ostringstream* oss) const
+{
+    *oss << "culled: ";
+    *oss << culled_count_;
+    *oss << ", drawn: ";
+    *oss << drawn_count_;
+}
@@ -0,0 +1,40 @@
+#ifndef ROBOFFRUSTUM_H_
+#define ROBOFFRUSTUM_H_
+#include <sstream>
+
+namespace GraphicsDatabase { class Matrix44; }
+class Sphere;
+
+using GraphicsDatabase::Matrix44;
+
+// The six planes of the view volume, taken from the perspective matrix, so
+// it holds whatever the camera convention is.  The normals face inside.
+class Frustum
+{
+public:
+    static const int PlaneSize = 6;
+    static const int Lanes = 4;
+
+private:
+    double normal_xs_[PlaneSize];
+    double normal_ys_[PlaneSize];
+    double normal_zs_[PlaneSize];
+    double distances_[PlaneSize];
+    mutable int culled_count_;
+    mutable int drawn_count_;
+
+public:
+    Frustum();
+    Frustum(const Matrix44& perspective);
+    ~Frustum();
+    bool contains(const Sphere& sphere) const;
+    int cull(   const double* xs,
+                const double* ys,
+                const double* zs,
+                const double* radii,
+                int size,
+                int* visibles) const;
+    void print(std::ostringstream* oss) const;
+};
+
+#endif
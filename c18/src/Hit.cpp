@@ -0,0 +1,19 @@
+#include "Hit.h"
+#include "GraphicsDatabase/Vector3.h"
+
+using GraphicsDatabase::Vector3;
+
+Hit::Hit(   int hit_bullet_handle,
+            Robo* hit_target,
+            const Vector3& hit_point,
+            const Vector3& hit_normal,
+            double hit_t)
+:   bullet_handle(hit_bullet_handle),
+    target(hit_target),
+    point(hit_point),
+    normal(hit_normal),
+    t(hit_t),
+    sequence(0)
+{}
+
+Hit::~Hit() {}
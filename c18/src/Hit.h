@@ -0,0 +1,28 @@
+#ifndef ROBOFHIT_H_
+#define ROBOFHIT_H_
+#include "GraphicsDatabase/Vector3.h"
+
+class Robo;
+
+using GraphicsDatabase::Vector3;
+
+class Hit
+{
+public:
+    int bullet_handle; // in TheArmoury, the slot of the bullet moves
+    Robo* target; // 0 when the horizon or a bullet was hit
+    Vector3 point;
+    Vector3 normal;
+    double t; // along the locus of the bullet, [0, 1]
+    unsigned sequence; // in the frame, numbered by TheHitQueue::apply
+
+public:
+    Hit(    int hit_bullet_handle,
+            Robo* hit_target,
+            const Vector3& hit_point,
+            const Vector3& hit_normal,
+            double hit_t);
+    ~Hit();
+};
+
+#endif
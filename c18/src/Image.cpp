@@ -0,0 +1,294 @@
+#include "Image.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int HeaderSize = 18;
+
+enum TgaType
+{
+    TgaColorMapped      = 1,
+    TgaTrueColor        = 2,
+    TgaGray             = 3,
+    TgaRle              = 8 // added to the others
+};
+
+} // namespace -
+
+namespace
+{
+
+int to_int16(const unsigned char* bytes)
+{
+    return bytes[0] | (bytes[1] << 8);
+}
+
+// little endian B, G, R and A, or 5 bits each of 16
+unsigned to_color(const unsigned char* bytes, int size)
+{
+    if (size == 1)
+    {
+        return 0xff000000 | (bytes[0] << 16) | (bytes[0] << 8) | bytes[0];
+    }
+    else if (size == 2)
+    {
+        const unsigned bits = to_int16(bytes);
+        const unsigned red   = ((bits >> 10) & 0x1f) * 255 / 31;
+        const unsigned green = ((bits >> 5) & 0x1f) * 255 / 31;
+        const unsigned blue  = ((bits >> 0) & 0x1f) * 255 / 31;
+        return 0xff000000 | (red << 16) | (green << 8) | blue;
+    }
+
+    const unsigned alpha = size == 4 ? bytes[3] : 0xff;
+    return (alpha << 24) | (bytes[2] << 16) | (bytes[1] << 8) | bytes[0];
+}
+
+unsigned char get_channel(unsigned color, int shift)
+{
+    return static_cast< unsigned char >((color >> shift) & 0xff);
+}
+
+} // namespace -
+
+// checks every read against the end, a short or broken file is not loaded
+bool Image::load(const std::string& filename, Image* image)
+{
+    *image = Image();
+    std::ifstream file(filename.c_str(), std::ios::binary);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    const std::string text = oss.str();
+    const unsigned char* bytes
+    = reinterpret_cast< const unsigned char* >(text.data());
+    const unsigned char* const end = bytes + text.size();
+
+    if (text.size() < static_cast< size_t >(HeaderSize))
+    {
+        return false;
+    }
+
+    const int id_size = bytes[0];
+    const bool has_map = bytes[1] != 0;
+    const int type = bytes[2] & ~TgaRle;
+    const bool is_rle = (bytes[2] & TgaRle) != 0;
+    const int map_begin = to_int16(&bytes[3]);
+    const int map_size = to_int16(&bytes[5]);
+    const int map_entry_size = (bytes[7] + 7) / 8;
+    const int width = to_int16(&bytes[12]);
+    const int height = to_int16(&bytes[14]);
+    const int pixel_size = (bytes[16] + 7) / 8;
+    const bool is_top_first = (bytes[17] & 0x20) != 0;
+
+    const bool is_type_read
+    = type == TgaTrueColor
+    || type == TgaGray
+    || (type == TgaColorMapped && has_map);
+    const bool is_pixel_read
+    = type == TgaColorMapped
+    ? pixel_size == 1 || pixel_size == 2
+    : pixel_size >= 1 && pixel_size <= 4;
+    const bool is_map_read
+    = !has_map || (map_entry_size >= 1 && map_entry_size <= 4);
+
+    if (!is_type_read || !is_pixel_read || !is_map_read)
+    {
+        return false;
+    }
+
+    if (end - bytes < HeaderSize + id_size)
+    {
+        return false;
+    }
+
+    bytes = bytes + HeaderSize + id_size;
+
+    std::vector< unsigned > map;
+
+    if (has_map)
+    {
+        if (end - bytes < map_size * map_entry_size)
+        {
+            return false;
+        }
+
+        map.resize(map_begin + map_size, 0xff000000);
+
+        for (int i = 0; i < map_size; ++i)
+        {
+            map.at(map_begin + i) = to_color(bytes, map_entry_size);
+            bytes = bytes + map_entry_size;
+        }
+    }
+
+    // a packet of RLE repeats 128 pixels at most, so a short file cannot
+    // claim a huge image
+    const long long pixel_count = static_cast< long long >(width) * height;
+
+    if (pixel_count > static_cast< long long >(end - bytes) * 128)
+    {
+        return false;
+    }
+
+    Image loaded(width, height);
+    const int size = width * height;
+    int count = 0;
+    bool is_raw = true;
+
+    for (int i = 0; i < size; ++i)
+    {
+        if (is_rle && count == 0)
+        {
+            if (bytes == end)
+            {
+                return false;
+            }
+
+            count = (*bytes & 0x7f) + 1;
+            is_raw = (*bytes & 0x80) == 0;
+            bytes = bytes + 1;
+        }
+
+        if (end - bytes < pixel_size)
+        {
+            return false;
+        }
+
+        unsigned color = 0;
+
+        if (type == TgaColorMapped)
+        {
+            const int index = pixel_size == 1 ? bytes[0] : to_int16(bytes);
+
+            if (index >= static_cast< int >(map.size()))
+            {
+                return false;
+            }
+
+            color = map.at(index);
+        }
+        else
+        {
+            color = to_color(bytes, pixel_size);
+        }
+
+        const int row = is_top_first ? i / width : height - 1 - i / width;
+        loaded.pixels_.at(row * width + i % width) = color;
+
+        // a run reads the same pixel again
+        count = count - 1;
+
+        if (!is_rle || is_raw || count == 0)
+        {
+            bytes = bytes + pixel_size;
+        }
+    }
+
+    *image = loaded;
+    return true;
+}
+
+Image::Image()
+:   width_(0), height_(0), pixels_()
+{
+}
+
+Image::Image(int width, int height)
+:   width_(width), height_(height), pixels_(width * height, 0)
+{
+    assert(width >= 0 && height >= 0);
+}
+
+Image::~Image() {}
+
+int Image::count_differences(const Image& other, int tolerance) const
+{
+    if (width_ != other.width_ || height_ != other.height_)
+    {
+        return static_cast< int >(pixels_.size());
+    }
+
+    int count = 0;
+
+    for (size_t i = 0; i < pixels_.size(); ++i)
+    {
+        for (int shift = 0; shift < 32; shift = shift + 8)
+        {
+            const int a = get_channel(pixels_.at(i), shift);
+            const int b = get_channel(other.pixels_.at(i), shift);
+
+            if (std::abs(a - b) > tolerance)
+            {
+                count = count + 1;
+                break;
+            }
+        }
+    }
+
+    return count;
+}
+
+unsigned Image::fetch(double u, double v) const
+{
+    assert(!pixels_.empty());
+    int x = static_cast< int >(std::floor(u * width_)) % width_;
+    int y = static_cast< int >(std::floor(v * height_)) % height_;
+    x = x < 0 ? x + width_ : x;
+    y = y < 0 ? y + height_ : y;
+    return pixels_[y * width_ + x];
+}
+
+void Image::fill(unsigned color)
+{
+    std::fill(pixels_.begin(), pixels_.end(), color);
+}
+
+int Image::height() const { return height_; }
+
+unsigned* Image::pixels() { return pixels_.empty() ? 0 : &pixels_.at(0); }
+
+const unsigned* Image::pixels() const
+{
+    return pixels_.empty() ? 0 : &pixels_.at(0);
+}
+
+void Image::save(const std::string& filename) const
+{
+    unsigned char header[HeaderSize] = { 0 };
+    header[2] = TgaTrueColor;
+    header[12] = static_cast< unsigned char >(width_ & 0xff);
+    header[13] = static_cast< unsigned char >(width_ >> 8);
+    header[14] = static_cast< unsigned char >(height_ & 0xff);
+    header[15] = static_cast< unsigned char >(height_ >> 8);
+    header[16] = 32;
+    header[17] = 0x20 | 8; // the top row first, 8 bits of alpha
+
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    assert(file);
+    file.write(reinterpret_cast< const char* >(header), HeaderSize);
+
+    for (size_t i = 0; i < pixels_.size(); ++i)
+    {
+        const unsigned color = pixels_.at(i);
+        const char bgra[4] = {  static_cast< char >(get_channel(color, 0)),
+                                static_cast< char >(get_channel(color, 8)),
+                                static_cast< char >(get_channel(color, 16)),
+                                static_cast< char >(get_channel(color, 24)) };
+        file.write(bgra, 4);
+    }
+}
+
+int Image::width() const { return width_; }
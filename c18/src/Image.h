@@ -0,0 +1,35 @@
+#ifndef ROBOFIMAGE_H_
+#define ROBOFIMAGE_H_
+#include <string>
+#include <vector>
+
+// 0xAARRGGBB pixels, the top row first.  Loads the TGA files of the data,
+// which are true color, gray or color mapped, with or without RLE.
+class Image
+{
+private:
+    int width_;
+    int height_;
+    std::vector< unsigned > pixels_;
+
+public:
+    // false when it cannot be read, the image is left empty
+    static bool load(const std::string& filename, Image* image);
+
+public:
+    Image();
+    Image(int width, int height);
+    ~Image();
+    // the count of the pixels which differ in a channel by more than the
+    // tolerance, the size of this one if the sizes differ
+    int count_differences(const Image& other, int tolerance) const;
+    unsigned fetch(double u, double v) const; // the nearest, wrapped
+    void fill(unsigned color);
+    int height() const;
+    unsigned* pixels();
+    const unsigned* pixels() const;
+    void save(const std::string& filename) const; // as a 32 bit TGA
+    int width() const;
+};
+
+#endif
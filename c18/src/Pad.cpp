@@ -1,8 +1,7 @@
 #include "Pad.h"
 #include <map>
 #include <utility>
-#include "GameLib/Input/Keyboard.h"
-#include "GameLib/Input/Manager.h"
+#include "Platform.h"
 
 namespace
 {
@@ -29,6 +28,9 @@ char key_at(Pad::Input input)
         case Pad::Option2:          key = 'u'; break;
         case Pad::Reset:            key = 'r'; break;
         case Pad::Terminate:        key = 't'; break;
+        case Pad::Profile:          key = 'p'; break;
+        case Pad::Weapon:           key = 'v'; break;
+        case Pad::Debug:            key = 'g'; break;
     }
 
     return key;
@@ -40,18 +42,9 @@ Pad::Pad(int id) : id_(id) {}
 
 Pad::~Pad() {}
 
-bool Pad::isOn(Input input) const
-{
-    GameLib::Input::Keyboard keyboard
-    = GameLib::Input::Manager::instance().keyboard();
-
-    return keyboard.isOn(key_at(input));
-}
+bool Pad::isOn(Input input) const { return Platform::is_on(key_at(input)); }
 
 bool Pad::isTriggered(Input input) const
 {
-    GameLib::Input::Keyboard keyboard
-    = GameLib::Input::Manager::instance().keyboard();
-
-    return keyboard.isTriggered(key_at(input));
+    return Platform::is_triggered(key_at(input));
 }
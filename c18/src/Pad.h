@@ -22,6 +22,9 @@ public:
         Option2,
         Reset,
         Terminate,
+        Profile,
+        Weapon,
+        Debug,
     };
 
 private:
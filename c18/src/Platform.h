@@ -0,0 +1,47 @@
+#ifndef ROBOFPLATFORM_H_
+#define ROBOFPLATFORM_H_
+#include "TheDrawQueue.h"
+
+namespace GameLib { class Texture; }
+class Image;
+
+// What the game needs of the machine it runs on: a clock, the keys, and a
+// renderer for the draw queue.  Platform/GameLib.cpp is the backend in the
+// GameLib shell of Windows, Platform/Headless.cpp the one with no window
+// nor GPU; a build links one of them.
+namespace Platform
+{
+
+unsigned time(); // [ms]
+
+bool is_on(char key);
+bool is_triggered(char key);
+
+int width();
+int height();
+int frame_rate();
+void request_end();
+bool is_end_requested();
+
+void create_texture(const char* filename, GameLib::Texture** texture);
+void destroy_texture(GameLib::Texture** texture);
+// the image is what a software renderer samples for the texture
+void texture(GameLib::Texture* texture, const Image* image);
+void blend_mode(TheDrawQueue::BlendMode mode);
+void enable_depth_test(bool does_test);
+void enable_depth_write(bool does_write);
+void draw_triangle( const double* p0,
+                    const double* p1,
+                    const double* p2,
+                    const double* t0,
+                    const double* t1,
+                    const double* t2,
+                    unsigned c0,
+                    unsigned c1,
+                    unsigned c2);
+void draw_string(int column, int row, const char* string);
+void end_frame(); // after the draw queue is flushed
+
+} // namespace Platform
+
+#endif
@@ -0,0 +1,110 @@
+#include "Platform.h"
+#include "GameLib/Framework.h"
+#include "GameLib/Input/Keyboard.h"
+#include "GameLib/Input/Manager.h"
+
+namespace
+{
+
+GameLib::Framework::BlendMode to_framework(TheDrawQueue::BlendMode mode)
+{
+    switch (mode)
+    {
+    case TheDrawQueue::BlendAdditive:
+        return GameLib::Framework::BLEND_ADDITIVE;
+    case TheDrawQueue::BlendOpaque:
+        return GameLib::Framework::BLEND_OPAQUE;
+    default:
+        return GameLib::Framework::BLEND_LINEAR;
+    }
+}
+
+} // namespace -
+
+namespace Platform
+{
+
+unsigned time() { return GameLib::Framework::instance().time(); }
+
+bool is_on(char key)
+{
+    GameLib::Input::Keyboard keyboard
+    = GameLib::Input::Manager::instance().keyboard();
+
+    return keyboard.isOn(key);
+}
+
+bool is_triggered(char key)
+{
+    GameLib::Input::Keyboard keyboard
+    = GameLib::Input::Manager::instance().keyboard();
+
+    return keyboard.isTriggered(key);
+}
+
+int width() { return GameLib::Framework::instance().width(); }
+
+int height() { return GameLib::Framework::instance().height(); }
+
+int frame_rate() { return GameLib::Framework::instance().frameRate(); }
+
+void request_end() { GameLib::Framework::instance().requestEnd(); }
+
+bool is_end_requested()
+{
+    return GameLib::Framework::instance().isEndRequested();
+}
+
+void create_texture(const char* filename, GameLib::Texture** texture)
+{
+    GameLib::Framework::instance().createTexture(texture, filename);
+}
+
+void destroy_texture(GameLib::Texture** texture)
+{
+    GameLib::Framework::instance().destroyTexture(texture);
+}
+
+void texture(GameLib::Texture* texture, const Image*)
+{
+    GameLib::Framework::instance().setTexture(texture);
+}
+
+void blend_mode(TheDrawQueue::BlendMode mode)
+{
+    GameLib::Framework::instance().setBlendMode(to_framework(mode));
+}
+
+void enable_depth_test(bool does_test)
+{
+    GameLib::Framework::instance().enableDepthTest(does_test);
+}
+
+void enable_depth_write(bool does_write)
+{
+    GameLib::Framework::instance().enableDepthWrite(does_write);
+}
+
+void draw_triangle( const double* p0,
+                    const double* p1,
+                    const double* p2,
+                    const double* t0,
+                    const double* t1,
+                    const double* t2,
+                    unsigned c0,
+                    unsigned c1,
+                    unsigned c2)
+{
+    GameLib::Framework f = GameLib::Framework::instance();
+    f.drawTriangle3DH(p0, p1, p2, t0, t1, t2, c0, c1, c2);
+}
+
+void draw_string(int column, int row, const char* string)
+{
+    GameLib::Framework::instance().drawDebugString(column, row, string);
+}
+
+// the framework presents the frame itself
+void end_frame() {}
+
+} // namespace Platform
@@ -0,0 +1,202 @@
+#include "Platform/Headless.h"
+#include <cassert>
+#include "Image.h"
+#include "Platform.h"
+#include "Rasterizer.h"
+
+namespace
+{
+
+const int KeySize = 256;
+const int FrameRate = 60;
+const unsigned ClearColor = 0xff000000;
+
+} // namespace -
+
+namespace
+{
+
+class Impl
+{
+private:
+    int width_;
+    int height_;
+    Rasterizer rasterizer_;
+    Image frame_;
+    unsigned frame_count_;
+    bool keys_[KeySize];
+    bool previous_keys_[KeySize];
+    bool is_end_requested_;
+
+public:
+    Impl(int width, int height, int thread_count);
+    ~Impl();
+    void end_frame();
+    const Image* frame() const;
+    int height() const;
+    bool is_end_requested() const;
+    bool is_on(char key) const;
+    bool is_triggered(char key) const;
+    void press(char key, bool is_on);
+    Rasterizer* rasterizer();
+    void request_end();
+    unsigned time() const;
+    int width() const;
+};
+
+Impl::Impl(int width, int height, int thread_count)
+:   width_(width), height_(height),
+    rasterizer_(width, height, thread_count),
+    frame_(width, height),
+    frame_count_(0),
+    is_end_requested_(false)
+{
+    for (int i = 0; i < KeySize; ++i)
+    {
+        keys_[i] = false;
+        previous_keys_[i] = false;
+    }
+
+    rasterizer_.clear(ClearColor);
+}
+
+Impl::~Impl() {}
+
+void Impl::end_frame()
+{
+    rasterizer_.flush();
+    frame_ = *rasterizer_.frame();
+    rasterizer_.clear(ClearColor);
+    frame_count_ = frame_count_ + 1;
+
+    for (int i = 0; i < KeySize; ++i)
+    {
+        previous_keys_[i] = keys_[i];
+    }
+}
+
+const Image* Impl::frame() const { return &frame_; }
+
+int Impl::height() const { return height_; }
+
+bool Impl::is_end_requested() const { return is_end_requested_; }
+
+int to_index(char key) { return static_cast< unsigned char >(key); }
+
+bool Impl::is_on(char key) const { return keys_[to_index(key)]; }
+
+bool Impl::is_triggered(char key) const
+{
+    return keys_[to_index(key)] && !previous_keys_[to_index(key)];
+}
+
+void Impl::press(char key, bool is_on) { keys_[to_index(key)] = is_on; }
+
+Rasterizer* Impl::rasterizer() { return &rasterizer_; }
+
+void Impl::request_end() { is_end_requested_ = true; }
+
+unsigned Impl::time() const { return frame_count_ * 1000 / FrameRate; }
+
+int Impl::width() const { return width_; }
+
+Impl* g_impl = 0;
+
+Rasterizer::BlendMode to_rasterizer(TheDrawQueue::BlendMode mode)
+{
+    switch (mode)
+    {
+    case TheDrawQueue::BlendAdditive:
+        return Rasterizer::BlendAdditive;
+    case TheDrawQueue::BlendOpaque:
+        return Rasterizer::BlendOpaque;
+    default:
+        return Rasterizer::BlendLinear;
+    }
+}
+
+} // namespace -
+
+namespace Platform
+{
+namespace Headless
+{
+
+void create(int width, int height, int thread_count)
+{
+    assert(!g_impl);
+    g_impl = new Impl(width, height, thread_count);
+}
+
+void destroy()
+{
+    assert(g_impl);
+    delete g_impl;
+    g_impl = 0;
+}
+
+const Image* frame() { return g_impl->frame(); }
+
+void press(char key, bool is_on) { g_impl->press(key, is_on); }
+
+} // namespace Headless
+
+unsigned time() { return g_impl->time(); }
+
+bool is_on(char key) { return g_impl->is_on(key); }
+
+bool is_triggered(char key) { return g_impl->is_triggered(key); }
+
+int width() { return g_impl->width(); }
+
+int height() { return g_impl->height(); }
+
+int frame_rate() { return FrameRate; }
+
+void request_end() { g_impl->request_end(); }
+
+bool is_end_requested() { return g_impl->is_end_requested(); }
+
+// the images are loaded by the ones which use them
+void create_texture(const char*, GameLib::Texture** texture) { *texture = 0; }
+
+void destroy_texture(GameLib::Texture** texture) { *texture = 0; }
+
+void texture(GameLib::Texture*, const Image* image)
+{
+    g_impl->rasterizer()->texture(image);
+}
+
+void blend_mode(TheDrawQueue::BlendMode mode)
+{
+    g_impl->rasterizer()->blend_mode(to_rasterizer(mode));
+}
+
+void enable_depth_test(bool does_test)
+{
+    g_impl->rasterizer()->enable_depth_test(does_test);
+}
+
+void enable_depth_write(bool does_write)
+{
+    g_impl->rasterizer()->enable_depth_write(does_write);
+}
+
+void draw_triangle( const double* p0,
+                    const double* p1,
+                    const double* p2,
+                    const double* t0,
+                    const double* t1,
+                    const double* t2,
+                    unsigned c0,
+                    unsigned c1,
+                    unsigned c2)
+{
+    g_impl->rasterizer()->add_triangle(p0, p1, p2, t0, t1, t2, c0, c1, c2);
+}
+
+void draw_string(int, int, const char*) {}
+
+void end_frame() { g_impl->end_frame(); }
+
+} // namespace Platform
@@ -0,0 +1,22 @@
+#ifndef ROBOFPLATFORMHEADLESS_H_
+#define ROBOFPLATFORMHEADLESS_H_
+
+class Image;
+
+// What only the headless backend has: the keys are pressed by the program,
+// the clock goes by a frame of 60 fps at each end of a frame, and the
+// frames are drawn by the software rasterizer.
+namespace Platform
+{
+namespace Headless
+{
+
+void create(int width, int height, int thread_count);
+void destroy();
+const Image* frame(); // the last one ended
+void press(char key, bool is_on);
+
+} // namespace Headless
+} // namespace Platform
+
+#endif
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "Image.h"
+#include "Platform.h"
+#include "Platform/Headless.h"
+#include "TheGame.h"
+#include "TheProfiler.h"
+
+namespace
+{
+
+const int Width         = 640;
+const int Height        = 480;
+const int DefaultFrames = 600; // 10 s at 60 fps
+const char* const DefaultTrace = "trace.json";
+
+} // namespace -
+
+// headless [frames] [keys held down] [TGA to save the last frame to]
+//          [JSON to save the trace of the frames to]
+int main(int argc, char** argv)
+{
+    const int frames = argc > 1 ? std::atoi(argv[1]) : DefaultFrames;
+    const std::string keys = argc > 2 ? argv[2] : "";
+    const int thread_count
+    = std::max(static_cast< int >(std::thread::hardware_concurrency()), 1);
+
+    Platform::Headless::create(Width, Height, thread_count);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        Platform::Headless::press(keys.at(i), true);
+    }
+
+    for (int i = 0; i < frames && !Platform::is_end_requested(); ++i)
+    {
+        TheGame::update();
+    }
+
+    if (argc > 3)
+    {
+        Platform::Headless::frame()->save(argv[3]);
+    }
+
+    // a frame to end in clears the game
+    if (!Platform::is_end_requested())
+    {
+        Platform::request_end();
+        TheGame::update();
+    }
+
+    TheProfiler::save(argc > 4 ? argv[4] : DefaultTrace);
+    Platform::Headless::destroy();
+    return 0;
+}
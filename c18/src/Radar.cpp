@@ -0,0 +1,200 @@
+#include "Radar.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "BatchTransform.h"
+#include "SweepHash.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const int HashBucketBits = 8;
+const double MaxAbsHeight = 50.0; // [m], the delta y of the darkest blip
+
+double my_scale(double x, double max_abs)
+{
+    if (x > 0.0)
+    {
+        if (x > max_abs)
+        {
+            return 1.0;
+        }
+        return x / max_abs;
+    }
+    else if (x < 0.0)
+    {
+        if (x < -max_abs)
+        {
+            return -1.0;
+        }
+        return x / max_abs;
+    }
+    return 0.0;
+}
+
+} // namespace -
+
+// a cell of the range, so a sweep visits 3 x 3 x 3 buckets
+Radar::Radar(double range, double scale_length, unsigned interval_ms)
+:   range_(range),
+    scale_length_(scale_length),
+    interval_ms_(interval_ms),
+    elapsed_ms_(0),
+    has_swept_(false),
+    xs_(), ys_(), zs_(),
+    hash_(range, HashBucketBits),
+    found_(),
+    is_in_range_(),
+    found_xs_(), found_ys_(), found_zs_(), transformed_(),
+    blip_xs_(), blip_ys_(), heights_(),
+    contact_count_(0),
+    sweep_count_(0)
+{
+    assert(range_ > 0.0 && scale_length_ > 0.0);
+}
+
+Radar::~Radar() {}
+
+void Radar::add(const Vector3& position)
+{
+    xs_.push_back(position.x);
+    ys_.push_back(position.y);
+    zs_.push_back(position.z);
+}
+
+int Radar::blip_count() const { return static_cast< int >(blip_xs_.size()); }
+
+double Radar::blip_height(int i) const { return heights_.at(i); }
+
+double Radar::blip_x(int i) const { return blip_xs_.at(i); }
+
+double Radar::blip_y(int i) const { return blip_ys_.at(i); }
+
+void Radar::print(std::ostringstream* oss) const
+{
+    *oss << "radar contacts: ";
+    *oss << contact_count_;
+    *oss << ", blips: ";
+    *oss << blip_xs_.size();
+    *oss << ", sweeps: ";
+    *oss << sweep_count_;
+}
+
+bool Radar::update(const Vector3& center, double angle_zx, unsigned delta_ms)
+{
+    elapsed_ms_ = elapsed_ms_ + delta_ms;
+    const bool is_due = !has_swept_ || elapsed_ms_ >= interval_ms_;
+
+    if (is_due)
+    {
+        sweep(center, angle_zx);
+        elapsed_ms_ = 0;
+        has_swept_ = true;
+    }
+
+    xs_.clear();
+    ys_.clear();
+    zs_.clear();
+    return is_due;
+}
+
+// the same transformation as the map of one opponent had, for all of them
+void Radar::sweep(const Vector3& center, double angle_zx)
+{
+    const int size = static_cast< int >(xs_.size());
+    contact_count_ = size;
+    sweep_count_ = sweep_count_ + 1;
+
+    hash_.clear();
+
+    for (int i = 0; i < size; ++i)
+    {
+        const Vector3 position(xs_.at(i), ys_.at(i), zs_.at(i));
+        hash_.add(i, position, position);
+    }
+
+    hash_.build();
+
+    Vector3 from(center);
+    Vector3 to(center);
+    from.add(Vector3(-range_, -range_, -range_));
+    to.add(Vector3(range_, range_, range_));
+    found_.clear();
+    hash_.find(from, to, &found_);
+
+    found_xs_.clear();
+    found_ys_.clear();
+    found_zs_.clear();
+    is_in_range_.assign(size, 0);
+
+    for (size_t i = 0; i < found_.size(); ++i)
+    {
+        const int contact = found_.at(i);
+        const double dx = xs_.at(contact) - center.x;
+        const double dz = zs_.at(contact) - center.z;
+
+        if (dx * dx + dz * dz <= range_ * range_)
+        {
+            found_xs_.push_back(xs_.at(contact));
+            found_ys_.push_back(ys_.at(contact));
+            found_zs_.push_back(zs_.at(contact));
+            is_in_range_.at(contact) = 1;
+        }
+    }
+
+    // the rest onto the circle of the range, in the same bearing
+    for (int i = 0; i < size; ++i)
+    {
+        if (is_in_range_.at(i))
+        {
+            continue;
+        }
+
+        const double dx = xs_.at(i) - center.x;
+        const double dz = zs_.at(i) - center.z;
+        const double rate = range_ / std::sqrt(dx * dx + dz * dz);
+        found_xs_.push_back(center.x + dx * rate);
+        found_ys_.push_back(ys_.at(i));
+        found_zs_.push_back(center.z + dz * rate);
+    }
+
+    const int found_size = static_cast< int >(found_xs_.size());
+    blip_xs_.resize(found_size);
+    blip_ys_.resize(found_size);
+    heights_.resize(found_size);
+
+    if (found_size == 0)
+    {
+        return;
+    }
+
+    Matrix44 transformation;
+    transformation.translate(-center);
+    transformation.rotate_zx(angle_zx);
+    double rows[4][4];
+    BatchTransform::get_rows(transformation, rows);
+    transformed_.resize(found_size);
+    BatchTransform::transform(  rows,
+                                &found_xs_.at(0),
+                                &found_ys_.at(0),
+                                &found_zs_.at(0),
+                                found_size,
+                                &transformed_.at(0));
+
+    for (int i = 0; i < found_size; ++i)
+    {
+        const double height
+        = std::max(-MaxAbsHeight,
+                    std::min(MaxAbsHeight, found_ys_.at(i) - center.y));
+        blip_xs_.at(i) = my_scale(transformed_.at(i).x, scale_length_);
+        blip_ys_.at(i) = -my_scale(transformed_.at(i).z, scale_length_);
+        heights_.at(i) = (height + MaxAbsHeight) / (2.0 * MaxAbsHeight);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef ROBOFRADAR_H_
+#define ROBOFRADAR_H_
+#include <sstream>
+#include <vector>
+#include "SweepHash.h"
+
+namespace GraphicsDatabase { class Vector3; }
+
+using GraphicsDatabase::Vector3;
+
+// The contacts around the player, as blips of the radar map.  The contacts
+// of a frame are hashed, the ones in the range are found, then moved into
+// the view of the player in one batch.  The farther ones are pulled onto
+// the range, so they are clamped at the edge of the map as well.  A sweep
+// is done once an interval, the blips stay until the next one.
+class Radar
+{
+private:
+    double range_; // [m], the contacts out of it are at the edge
+    double scale_length_; // [m], to the edge of the map, farther on it
+    unsigned interval_ms_;
+    unsigned elapsed_ms_; // since the last sweep
+    bool has_swept_;
+    // the contacts of the frame
+    std::vector< double > xs_;
+    std::vector< double > ys_;
+    std::vector< double > zs_;
+    SweepHash hash_;
+    std::vector< int > found_;
+    std::vector< char > is_in_range_; // of the contacts
+    // the contacts in the range
+    std::vector< double > found_xs_;
+    std::vector< double > found_ys_;
+    std::vector< double > found_zs_;
+    std::vector< Vector3 > transformed_;
+    // the blips, in [-1, 1], x to the right and y to the front
+    std::vector< double > blip_xs_;
+    std::vector< double > blip_ys_;
+    std::vector< double > heights_; // 0 far below, 0.5 level, 1 far above
+    int contact_count_;
+    int sweep_count_;
+
+public:
+    Radar(double range, double scale_length, unsigned interval_ms);
+    ~Radar();
+    void add(const Vector3& position);
+    int blip_count() const;
+    double blip_height(int i) const;
+    double blip_x(int i) const;
+    double blip_y(int i) const;
+    void print(std::ostringstream* oss) const;
+    // true when swept, the contacts are cleared anyway
+    bool update(const Vector3& center, double angle_zx, unsigned delta_ms);
+
+private:
+    void sweep(const Vector3& center, double angle_zx);
+};
+
+#endif
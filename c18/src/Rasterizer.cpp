@@ -0,0 +1,505 @@
+#include "Rasterizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "Image.h"
+
+namespace
+{
+
+const double NearW = 1.0e-5; // clipped by w >= this, not to divide by 0
+const int VertexSize = 10; // x, y, z, w, u, v, a, r, g, b
+const int MaxClippedVertexes = 4;
+const size_t ReservedTriangles = 4096;
+
+} // namespace -
+
+namespace
+{
+
+void set_vertex(    const double* p,
+                    const double* t,
+                    unsigned color,
+                    double* vertex)
+{
+    std::copy(p, p + 4, vertex);
+    vertex[4] = t ? t[0] : 0.0;
+    vertex[5] = t ? t[1] : 0.0;
+    vertex[6] = static_cast< double >((color >> 24) & 0xff);
+    vertex[7] = static_cast< double >((color >> 16) & 0xff);
+    vertex[8] = static_cast< double >((color >> 8) & 0xff);
+    vertex[9] = static_cast< double >((color >> 0) & 0xff);
+}
+
+// Sutherland-Hodgman by the one plane, all the attributes are linear in the
+// clip space.  A triangle is at most a quad after it.
+int clip_by_near(   const double (*vertexes)[VertexSize],
+                    double (*clipped)[VertexSize])
+{
+    int size = 0;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const double* a = vertexes[i];
+        const double* b = vertexes[(i + 1) % 3];
+        const double da = a[3] - NearW;
+        const double db = b[3] - NearW;
+
+        if (da >= 0.0)
+        {
+            std::copy(a, a + VertexSize, clipped[size]);
+            size = size + 1;
+        }
+
+        if ((da >= 0.0) != (db >= 0.0))
+        {
+            const double t = da / (da - db);
+
+            for (int j = 0; j < VertexSize; ++j)
+            {
+                clipped[size][j] = a[j] + (b[j] - a[j]) * t;
+            }
+
+            size = size + 1;
+        }
+    }
+
+    assert(size <= MaxClippedVertexes);
+    return size;
+}
+
+double dot3(const double* l, const double* xs)
+{
+    return l[0] * xs[0] + l[1] * xs[1] + l[2] * xs[2];
+}
+
+int to_channel(double x)
+{
+    return x <= 0.0 ? 0 : x >= 255.0 ? 255 : static_cast< int >(x + 0.5);
+}
+
+unsigned get_channel(unsigned color, int shift)
+{
+    return (color >> shift) & 0xff;
+}
+
+} // namespace -
+
+Rasterizer::Rasterizer(int width, int height, int thread_count)
+:   width_(width), height_(height),
+    thread_count_(std::max(thread_count, 1)),
+    tile_columns_((width + TileSize - 1) / TileSize),
+    tile_rows_((height + TileSize - 1) / TileSize),
+    frame_(width, height),
+    depths_(width * height, 1.0f),
+    states_(), current_(), current_index_(-1),
+    setups_(), bins_(), pixel_counts_(),
+    triangle_count_(0), clipped_count_(0), binned_count_(0),
+    pixel_count_(0)
+{
+    assert(width > 0 && height > 0);
+    current_.image = 0;
+    current_.blend_mode = BlendLinear;
+    current_.does_test_depth = true;
+    current_.does_write_depth = true;
+    setups_.reserve(ReservedTriangles);
+    bins_.resize(tile_columns_ * tile_rows_);
+    pixel_counts_.resize(thread_count_, 0);
+}
+
+Rasterizer::~Rasterizer() {}
+
+void Rasterizer::add_triangle(  const double* p0,
+                                const double* p1,
+                                const double* p2,
+                                const double* t0,
+                                const double* t1,
+                                const double* t2,
+                                unsigned c0,
+                                unsigned c1,
+                                unsigned c2)
+{
+    triangle_count_ = triangle_count_ + 1;
+
+    double vertexes[3][VertexSize];
+    set_vertex(p0, t0, c0, vertexes[0]);
+    set_vertex(p1, t1, c1, vertexes[1]);
+    set_vertex(p2, t2, c2, vertexes[2]);
+
+    double clipped[MaxClippedVertexes][VertexSize];
+    const int size = clip_by_near(vertexes, clipped);
+
+    if (size < 3)
+    {
+        clipped_count_ = clipped_count_ + 1;
+        return;
+    }
+
+    for (int i = 1; i + 1 < size; ++i)
+    {
+        set_up(clipped[0], clipped[i], clipped[i + 1]);
+    }
+}
+
+// the tiles which the box of the triangle overlaps, less the ones wholly
+// outside of an edge
+void Rasterizer::bin(int setup_index)
+{
+    const Setup& setup = setups_.at(setup_index);
+    const int min_column = setup.min_x / TileSize;
+    const int max_column = setup.max_x / TileSize;
+    const int min_row = setup.min_y / TileSize;
+    const int max_row = setup.max_y / TileSize;
+
+    for (int row = min_row; row <= max_row; ++row)
+    {
+        for (int column = min_column; column <= max_column; ++column)
+        {
+            const double x0 = column * TileSize;
+            const double y0 = row * TileSize;
+            const double x1 = x0 + TileSize;
+            const double y1 = y0 + TileSize;
+            bool is_outside = false;
+
+            for (int i = 0; i < 3 && !is_outside; ++i)
+            {
+                const double* edge = setup.edges[i];
+                const double x = edge[0] > 0.0 ? x1 : x0;
+                const double y = edge[1] > 0.0 ? y1 : y0;
+                is_outside = edge[0] * x + edge[1] * y + edge[2] < 0.0;
+            }
+
+            if (!is_outside)
+            {
+                bins_.at(row * tile_columns_ + column).push_back(setup_index);
+                binned_count_ = binned_count_ + 1;
+            }
+        }
+    }
+}
+
+void Rasterizer::blend_mode(BlendMode mode)
+{
+    assert(mode >= 0 && mode < BlendModeSize);
+    current_.blend_mode = mode;
+    current_index_ = -1;
+}
+
+void Rasterizer::clear(unsigned color)
+{
+    frame_.fill(color);
+    std::fill(depths_.begin(), depths_.end(), 1.0f);
+    triangle_count_ = 0;
+    clipped_count_ = 0;
+    binned_count_ = 0;
+    pixel_count_ = 0;
+}
+
+void Rasterizer::enable_depth_test(bool does_test)
+{
+    current_.does_test_depth = does_test;
+    current_index_ = -1;
+}
+
+void Rasterizer::enable_depth_write(bool does_write)
+{
+    current_.does_write_depth = does_write;
+    current_index_ = -1;
+}
+
+// The edges of Lanes pixels of a row are tested at once with no branch, so
+// the compiler can vectorize it; then the covered ones are shaded.
+void Rasterizer::fill_tile(int tile, int* pixel_count)
+{
+    const int tile_x = (tile % tile_columns_) * TileSize;
+    const int tile_y = (tile / tile_columns_) * TileSize;
+    const std::vector< int >& bin = bins_.at(tile);
+    unsigned* const pixels = frame_.pixels();
+
+    for (size_t i = 0; i < bin.size(); ++i)
+    {
+        const Setup& setup = setups_.at(bin.at(i));
+        const State& state = states_.at(setup.state);
+        const int min_x = std::max(setup.min_x, tile_x);
+        const int max_x = std::min(setup.max_x, tile_x + TileSize - 1);
+        const int min_y = std::max(setup.min_y, tile_y);
+        const int max_y = std::min(setup.max_y, tile_y + TileSize - 1);
+
+        for (int y = min_y; y <= max_y; ++y)
+        {
+            const double py = y + 0.5;
+
+            for (int x = min_x; x <= max_x; x = x + Lanes)
+            {
+                double es[3][Lanes];
+                int insides[Lanes];
+
+                for (int lane = 0; lane < Lanes; ++lane)
+                {
+                    const double px = x + lane + 0.5;
+                    int inside = x + lane <= max_x;
+
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const double* edge = setup.edges[k];
+                        const double e = edge[0] * px + edge[1] * py + edge[2];
+                        es[k][lane] = e;
+                        inside = inside
+                        & (e > 0.0 || (e == 0.0 && setup.is_top_left[k]));
+                    }
+
+                    insides[lane] = inside;
+                }
+
+                for (int lane = 0; lane < Lanes; ++lane)
+                {
+                    if (!insides[lane])
+                    {
+                        continue;
+                    }
+
+                    const int index = y * width_ + x + lane;
+                    double l[3];
+                    l[0] = es[0][lane] * setup.inverse_area;
+                    l[1] = es[1][lane] * setup.inverse_area;
+                    l[2] = 1.0 - l[0] - l[1];
+                    const double z = dot3(l, setup.zs);
+
+                    if (state.does_test_depth && !(z < depths_[index]))
+                    {
+                        continue;
+                    }
+
+                    const double w = 1.0 / dot3(l, setup.inverse_ws);
+                    double channels[4];
+
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        channels[k] = (l[0] * setup.colors[0][k]
+                                    + l[1] * setup.colors[1][k]
+                                    + l[2] * setup.colors[2][k]) * w;
+                    }
+
+                    if (state.image)
+                    {
+                        const double u = (l[0] * setup.uvs[0][0]
+                                        + l[1] * setup.uvs[1][0]
+                                        + l[2] * setup.uvs[2][0]) * w;
+                        const double v = (l[0] * setup.uvs[0][1]
+                                        + l[1] * setup.uvs[1][1]
+                                        + l[2] * setup.uvs[2][1]) * w;
+                        const unsigned texel = state.image->fetch(u, v);
+
+                        for (int k = 0; k < 4; ++k)
+                        {
+                            const int shift = 24 - 8 * k;
+                            channels[k]
+                            = channels[k] * get_channel(texel, shift) / 255.0;
+                        }
+                    }
+
+                    const unsigned destination = pixels[index];
+                    const double alpha = channels[0] / 255.0;
+                    unsigned color = 0;
+
+                    for (int k = 0; k < 4; ++k)
+                    {
+                        const int shift = 24 - 8 * k;
+                        const double to = get_channel(destination, shift);
+                        double from = channels[k];
+
+                        if (state.blend_mode == BlendLinear && k > 0)
+                        {
+                            from = from * alpha + to * (1.0 - alpha);
+                        }
+                        else if (state.blend_mode == BlendAdditive && k > 0)
+                        {
+                            from = from * alpha + to;
+                        }
+
+                        color = color | (to_channel(from) << shift);
+                    }
+
+                    pixels[index] = color;
+
+                    if (state.does_write_depth)
+                    {
+                        depths_[index] = static_cast< float >(z);
+                    }
+
+                    *pixel_count = *pixel_count + 1;
+                }
+            }
+        }
+    }
+}
+
+// the tiles are dealt to the threads in turn
+void Rasterizer::fill_tiles(int first_tile, int* pixel_count)
+{
+    int count = 0;
+
+    for (int tile = first_tile;
+         tile < tile_columns_ * tile_rows_;
+         tile = tile + thread_count_)
+    {
+        fill_tile(tile, &count);
+    }
+
+    *pixel_count = count;
+}
+
+// A frame has a few states, so a linear search is enough.
+int Rasterizer::find_state()
+{
+    for (size_t i = 0; i < states_.size(); ++i)
+    {
+        const State& state = states_.at(i);
+
+        if (state.image == current_.image
+            && state.blend_mode == current_.blend_mode
+            && state.does_test_depth == current_.does_test_depth
+            && state.does_write_depth == current_.does_write_depth)
+        {
+            return static_cast< int >(i);
+        }
+    }
+
+    states_.push_back(current_);
+    return static_cast< int >(states_.size()) - 1;
+}
+
+void Rasterizer::flush()
+{
+    std::vector< std::thread > threads;
+
+    for (int i = 1; i < thread_count_; ++i)
+    {
+        threads.push_back(std::thread(  &Rasterizer::fill_tiles,
+                                        this,
+                                        i,
+                                        &pixel_counts_.at(i)));
+    }
+
+    fill_tiles(0, &pixel_counts_.at(0));
+
+    for (size_t i = 0; i < threads.size(); ++i)
+    {
+        threads.at(i).join();
+    }
+
+    for (int i = 0; i < thread_count_; ++i)
+    {
+        pixel_count_ = pixel_count_ + pixel_counts_.at(i);
+    }
+
+    for (size_t i = 0; i < bins_.size(); ++i)
+    {
+        bins_.at(i).clear();
+    }
+
+    setups_.clear();
+    states_.clear();
+    current_index_ = -1;
+}
+
+const Image* Rasterizer::frame() const { return &frame_; }
+
+void Rasterizer::print(std::ostringstream* oss) const
+{
+    *oss << "triangles: ";
+    *oss << triangle_count_;
+    *oss << " (clipped ";
+    *oss << clipped_count_;
+    *oss << "), binned: ";
+    *oss << binned_count_;
+    *oss << ", pixels: ";
+    *oss << pixel_count_;
+}
+
+// to the screen, from the top left, the depth is z / w
+void Rasterizer::set_up(const double* v0, const double* v1, const double* v2)
+{
+    const double* const vertexes[3] = { v0, v1, v2 };
+    Setup setup;
+    double xs[3];
+    double ys[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const double* vertex = vertexes[i];
+        const double inverse_w = 1.0 / vertex[3];
+        xs[i] = (vertex[0] * inverse_w + 1.0) * 0.5 * width_;
+        ys[i] = (1.0 - vertex[1] * inverse_w) * 0.5 * height_;
+        setup.zs[i] = vertex[2] * inverse_w;
+        setup.inverse_ws[i] = inverse_w;
+        setup.uvs[i][0] = vertex[4] * inverse_w;
+        setup.uvs[i][1] = vertex[5] * inverse_w;
+
+        for (int k = 0; k < 4; ++k)
+        {
+            setup.colors[i][k] = vertex[6 + k] * inverse_w;
+        }
+    }
+
+    double area = (xs[1] - xs[0]) * (ys[2] - ys[0])
+                - (xs[2] - xs[0]) * (ys[1] - ys[0]);
+
+    if (area == 0.0)
+    {
+        return;
+    }
+
+    // either winding is drawn, so the edges are turned to be positive inside
+    const double sign = area > 0.0 ? 1.0 : -1.0;
+    area = area * sign;
+
+    // the edge i is the opposite one of the vertex i, 1 at the vertex
+    for (int i = 0; i < 3; ++i)
+    {
+        const int j = (i + 1) % 3;
+        const int k = (i + 2) % 3;
+        const double a = -(ys[k] - ys[j]) * sign;
+        const double b = (xs[k] - xs[j]) * sign;
+        setup.edges[i][0] = a;
+        setup.edges[i][1] = b;
+        setup.edges[i][2] = -(a * xs[j] + b * ys[j]);
+        setup.is_top_left[i] = a > 0.0 || (a == 0.0 && b > 0.0);
+    }
+
+    setup.inverse_area = 1.0 / area;
+
+    const double min_x = std::min(xs[0], std::min(xs[1], xs[2]));
+    const double max_x = std::max(xs[0], std::max(xs[1], xs[2]));
+    const double min_y = std::min(ys[0], std::min(ys[1], ys[2]));
+    const double max_y = std::max(ys[0], std::max(ys[1], ys[2]));
+
+    if (max_x < 0.0 || max_y < 0.0 || min_x >= width_ || min_y >= height_)
+    {
+        return;
+    }
+
+    setup.min_x = std::max(static_cast< int >(std::floor(min_x)), 0);
+    setup.min_y = std::max(static_cast< int >(std::floor(min_y)), 0);
+    setup.max_x = std::min(static_cast< int >(std::ceil(max_x)), width_ - 1);
+    setup.max_y = std::min(static_cast< int >(std::ceil(max_y)), height_ - 1);
+
+    if (current_index_ < 0)
+    {
+        current_index_ = find_state();
+    }
+
+    setup.state = current_index_;
+    setups_.push_back(setup);
+    bin(static_cast< int >(setups_.size()) - 1);
+}
+
+// an empty one, of a file which could not be loaded, is drawn as none
+void Rasterizer::texture(const Image* image)
+{
+    current_.image = image && image->pixels() ? image : 0;
+    current_index_ = -1;
+}
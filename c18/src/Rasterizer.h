@@ -0,0 +1,103 @@
+#ifndef ROBOFRASTERIZER_H_
+#define ROBOFRASTERIZER_H_
+#include <sstream>
+#include <vector>
+#include "Image.h"
+
+// A software backend for the triangles of Framework::drawTriangle3DH, for
+// the machines with no window nor GPU.  The triangles are clipped by the
+// near plane, set up and binned into the tiles of the screen, then the
+// tiles are filled by the threads, each tile by one thread in the order
+// the triangles were added.  UVs and colors are perspective correct, the
+// texture is multiplied by the color, and there is a depth buffer.
+class Rasterizer
+{
+public:
+    enum BlendMode
+    {
+        BlendLinear,
+        BlendAdditive,
+        BlendOpaque,
+        BlendModeSize
+    };
+
+    static const int TileSize = 32; // [pixel]
+    static const int Lanes = 4; // pixels of a row tested at once
+
+private:
+    struct State
+    {
+        const Image* image;
+        BlendMode blend_mode;
+        bool does_test_depth;
+        bool does_write_depth;
+    };
+
+    // a triangle in the screen, the attributes divided by w
+    struct Setup
+    {
+        double edges[3][3]; // a x + b y + c, positive inside
+        bool is_top_left[3]; // owns the pixels on the edge
+        double inverse_area;
+        double zs[3];
+        double inverse_ws[3];
+        double uvs[3][2];
+        double colors[3][4]; // a, r, g, b
+        int min_x;
+        int min_y;
+        int max_x;
+        int max_y;
+        int state;
+    };
+
+private:
+    int width_;
+    int height_;
+    int thread_count_;
+    int tile_columns_;
+    int tile_rows_;
+    Image frame_;
+    std::vector< float > depths_;
+    std::vector< State > states_;
+    State current_;
+    int current_index_;
+    std::vector< Setup > setups_;
+    std::vector< std::vector< int > > bins_;
+    std::vector< int > pixel_counts_; // of each thread
+    int triangle_count_;
+    int clipped_count_;
+    int binned_count_;
+    int pixel_count_;
+
+public:
+    Rasterizer(int width, int height, int thread_count);
+    ~Rasterizer();
+    void add_triangle(  const double* p0,
+                        const double* p1,
+                        const double* p2,
+                        const double* t0,
+                        const double* t1,
+                        const double* t2,
+                        unsigned c0,
+                        unsigned c1,
+                        unsigned c2);
+    void blend_mode(BlendMode mode);
+    void clear(unsigned color);
+    void enable_depth_test(bool does_test);
+    void enable_depth_write(bool does_write);
+    void flush(); // fills the tiles with the triangles added so far
+    const Image* frame() const;
+    void print(std::ostringstream* oss) const;
+    void texture(const Image* image);
+
+private:
+    Rasterizer(const Rasterizer&);
+    Rasterizer& operator=(const Rasterizer&);
+    void bin(int setup_index);
+    void fill_tile(int tile, int* pixel_count);
+    void fill_tiles(int first_tile, int* pixel_count);
+    int find_state();
+    void set_up(const double* v0, const double* v1, const double* v2);
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "Robo.h"
+#include <cmath>
 #include <cstdlib>
 #include <sstream>
 #include <string>
@@ -10,14 +11,19 @@
 #include "GraphicsDatabase/Tree.h"
 #include "GraphicsDatabase/Vector3.h"
 #include "Ai/TheArmoury.h"
-#include "Cuboid.h"
+#include "Bullet.h"
+#include "Capsule.h"
+#include "FastMath.h"
+#include "Frustum.h"
 #include "Segment.h"
 #include "Sphere.h"
 #include "TheDatabase.h"
 #include "TheEnvironment.h"
+#include "ThePoses.h"
 #include "TheTime.h"
 #include "Triangle.h"
 #include "View.h"
+#include "WeaponProfile.h"
 
 using GraphicsDatabase::Matrix44;
 using GraphicsDatabase::Model;
@@ -34,6 +40,11 @@ const double Volume     = 2.0 * HalfWidth * 2.0 * HalfWidth * Height;
 const double Density    = TheMass / Volume; // 945; // [kg/m^3]
 const double DragArea   = 2.0 * HalfWidth * Height;
 
+const double CapsuleRadius      = HalfWidth; // [m]
+const double CapsuleHalfHeight  = 1.0; // [m], same as the robo model
+const double BoundingRadius
+= std::sqrt(Height * Height + 2.0 * HalfWidth * HalfWidth);
+
 const double AirDensity     = 1.293; // [kg/m^3]
 const double AirViscosity   = 1.8 * 1e-5;
 
@@ -44,6 +55,14 @@ const int AngleScale = 3;
 
 const unsigned ChargingMs = 200;
 
+// the weapons switched in turn, the homing one is fired when locking on
+const char* const Loadout[] = { "rifle", "shotgun", "flak", "laser" };
+const int LoadoutSize = sizeof(Loadout) / sizeof(Loadout[0]);
+
+// the missiles which will pass within the radius in the seconds
+const double DefenceRadius  = 3.0; // [m]
+const double DefenceSeconds = 1.0; // [s]
+
 const double AbsorptionEnergyPerMs  = 0.001;
 const double BoostEnergyPerMs       = 0.0004;
 
@@ -69,6 +88,7 @@ void set_angle(Tree* tree, Model* collider, const Vector3& new_value)
 Robo::Robo(const std::string& id)
 :   id_(id),
     tree_(0),
+    pose_(-1),
     collider_(0),
     force_(),
     velocity_(),
@@ -77,6 +97,11 @@ Robo::Robo(const std::string& id)
     mass_(TheMass),
     view_(0),
     weapon_state_(WeaponStateReady),
+    weapon_index_(0),
+    weapon_(0),
+    homing_weapon_(0),
+    defence_weapon_(0),
+    threats_(),
     state_counter_(0),
     is_locking_on_(false),
     sighting_ms_(0),
@@ -85,11 +110,16 @@ Robo::Robo(const std::string& id)
 {
     TheDatabase::instance().create(id_, "robo");
     tree_ = TheDatabase::instance().find(id_);
+    pose_ = ThePoses::instance().add("robo");
     TheDatabase::instance().create_model(id_, "cube");
     collider_ = TheDatabase::instance().find_model(id_);
     collider_->position(*(tree_->balance()));
     set_balance(tree_, collider_, *(tree_->balance()));
     delta_next_position_.copy_from(*(tree_->balance()));
+    weapon_ = TheDatabase::instance().find_weapon(Loadout[weapon_index_]);
+    homing_weapon_ = TheDatabase::instance().find_weapon("missile");
+    defence_weapon_ = TheDatabase::instance().find_weapon("flak");
+    ASSERT(weapon_ && homing_weapon_ && defence_weapon_);
 }
 
 Robo::~Robo()
@@ -271,58 +301,94 @@ void Robo::boost(const Vector3& direction)
     add_force(&force_, angle_zx_, tuned_direction, a);
 }
 
-Cuboid Robo::cuboid() const
+Sphere Robo::bounding_sphere() const
+{
+    return Sphere(*center(), BoundingRadius);
+}
+
+Capsule Robo::capsule() const
+{
+    const Vector3* balance = tree_->balance();
+    Vector3 bottom(*balance);
+    bottom.y = bottom.y - (CapsuleHalfHeight - CapsuleRadius);
+    Vector3 top(*balance);
+    top.y = top.y + (CapsuleHalfHeight - CapsuleRadius);
+    return Capsule(bottom, top, CapsuleRadius);
+}
+
+void Robo::commit_next_position()
+{
+    Vector3 next_position(*(tree_->balance()));
+    next_position.add(delta_next_position_);
+    set_balance(tree_, collider_, next_position);
+    ThePoses::instance().root(pose_, *tree_->balance(), *tree_->angle());
+}
+
+const Vector3* Robo::center() const { return tree_->balance(); }
+
+double Robo::collider_radius() const
 {
     const Vector3* vertexes = collider_->vertexes();
     size_t size = collider_->vertexes_size();
-    Vector3 half_size;
-
-    // model has not been translated, it keeps vertexes (0, 0, 0) coordinate
+    double max_length = 0.0;
 
     for (size_t i = 0; i < size; ++i)
     {
-        double dx = get_abs(vertexes[i].x);
-        double dy = get_abs(vertexes[i].y);
-        double dz = get_abs(vertexes[i].z);
-
-        if (dx > half_size.x)
+        if (vertexes[i].length() > max_length)
         {
-            half_size.x = dx;
+            max_length = vertexes[i].length();
         }
+    }
 
-        if (dy > half_size.y)
-        {
-            half_size.y = dy;
-        }
+    return max_length;
+}
+
+// Aimed only in the zx plane.  The missiles home to the center, so they
+// come in near its height.
+void Robo::defend()
+{
+    if (weapon_state_ != WeaponStateReady)
+    {
+        return;
+    }
 
-        if (dz > half_size.z)
+    const Ai::TheArmoury armoury = Ai::TheArmoury::instance();
+    threats_.clear();
+    armoury.find_threats(*this, DefenceRadius, DefenceSeconds, &threats_);
+    const Bullet* missile = 0;
+
+    for (size_t i = 0; i < threats_.size() && !missile; ++i)
+    {
+        const Bullet* bullet = armoury.find(threats_.at(i));
+
+        if (bullet && bullet->profile()->kind == WeaponProfile::KindHoming)
         {
-            half_size.z = dz;
+            missile = bullet;
         }
     }
 
-    Vector3 next_position(*(tree_->balance()));
-    next_position.add(delta_next_position_);
-
-    return Cuboid(next_position, half_size);
-}
+    if (!missile)
+    {
+        return;
+    }
 
-void Robo::commit_next_position()
-{
-    Vector3 next_position(*(tree_->balance()));
-    next_position.add(delta_next_position_);
-    set_balance(tree_, collider_, next_position);
-    tree_->update(TheTime::instance().delta());
+    Vector3 to_missile(*missile->point());
+    to_missile.subtract(*center());
+    const Vector3 angle(   0.0,
+                            Trigonometry::atan2(to_missile.x, to_missile.z),
+                            0.0);
+    armoury.fire(*this, *center(), angle, 0, *defence_weapon_);
+    weapon_state_ = WeaponStateCharging;
 }
 
-const Vector3* Robo::center() const { return tree_->balance(); }
-
 void Robo::draw(const View& view) const
 {
-    tree_->draw_flat_shading(   view.get_perspective_matrix(),
-                                TheEnvironment::Brightness,
-                                TheEnvironment::AmbientBrightness,
-                                TheEnvironment::LightVector);
+    if (!view.frustum()->contains(bounding_sphere()))
+    {
+        return;
+    }
+
+    ThePoses::instance().draw(pose_, view);
 }
 
 namespace
@@ -365,7 +431,9 @@ void Robo::fire_bullet(const Robo* opponent)
                                         *tree_->balance(),
                                         modified_angle,
                                         opponent,
-                                        is_locking_on_);
+                                        is_locking_on_
+                                        ? *homing_weapon_
+                                        : *weapon_);
 
     weapon_state_ = WeaponStateCharging;
 }
@@ -387,7 +455,7 @@ const unsigned MsToCompleteLockOn   = 3000;
 
 double calc_half_theta_at_depth(double depth)
 {
-    return GameLib::atan2(HalfHeightAtMaxDepth, depth);
+    return Trigonometry::atan2(HalfHeightAtMaxDepth, depth);
 }
 
 } // namespace -
@@ -398,7 +466,7 @@ double Robo::get_half_sight_size_at_depth(const Robo& opponent) const
     to_opponent_point.subtract(*view_->center());
     const double depth = to_opponent_point.length();
     const double theta = calc_half_theta_at_depth(depth);
-    const double length_at_depth = depth * GameLib::tan(theta);
+    const double length_at_depth = depth * Trigonometry::tan(theta);
     return length_at_depth;
 }
 
@@ -435,36 +503,11 @@ void Robo::get_triangles(std::vector< Triangle >* triangles) const
     }
 }
 
-Cuboid Robo::locus_cuboid() const
+Segment Robo::locus_segment() const
 {
-    const Vector3* vertexes = collider_->vertexes();
-    size_t size = collider_->vertexes_size();
-    double max_length = 0.0;
-
-    for (size_t i = 0; i < size; ++i)
-    {
-        if (vertexes[i].length() > max_length)
-        {
-            max_length = vertexes[i].length();
-        }
-    }
-
-    Vector3 half_size(max_length, max_length, max_length);
-
     Vector3 previous(*center());
     previous.subtract(delta_next_position_);
-
-    Vector3 balance(*center());
-    balance.subtract(previous);
-    balance.divide(2.0);
-
-    half_size.x = half_size.x + balance.x;
-    half_size.y = half_size.y + balance.y;
-    half_size.z = half_size.z + balance.z;
-
-    balance.add(previous);
-
-    return Cuboid(balance, half_size);
+    return Segment(previous, *center());
 }
 
 void Robo::print(std::ostringstream* oss) const
@@ -521,34 +564,6 @@ Segment Robo::segment() const
     return Segment(next_position, to);
 }
 
-std::vector< Segment > Robo::segments() const
-{
-    std::vector< Segment > segments;
-    segments.reserve(2);
-    Vector3 balance(*(tree_->balance()));
-    balance.add(delta_next_position_);
-
-    Vector3 x0(balance);
-    x0.x = x0.x - 0.25;
-    Vector3 x1(balance);
-    x1.x = x1.x + 0.25;
-    segments.push_back(Segment(x0, x1));
-
-    Vector3 y0(balance);
-    y0.y = y0.y - 1.0;
-    Vector3 y1(balance);
-    y1.y = y1.y + 1.0;
-    segments.push_back(Segment(y0, y1));
-
-    Vector3 z0(balance);
-    z0.z = z0.z - 0.25;
-    Vector3 z1(balance);
-    z1.z = z1.z + 0.25;
-    segments.push_back(Segment(z0, z1));
-
-    return segments;
-}
-
 void Robo::set_model_angle_zx(double new_value)
 {
     angle_zx_ = new_value;
@@ -557,6 +572,13 @@ void Robo::set_model_angle_zx(double new_value)
     set_angle(tree_, collider_, angle);
 }
 
+void Robo::switch_weapon()
+{
+    weapon_index_ = (weapon_index_ + 1) % LoadoutSize;
+    weapon_ = TheDatabase::instance().find_weapon(Loadout[weapon_index_]);
+    ASSERT(weapon_);
+}
+
 void Robo::update(const Robo& opponent)
 {
     lock_on(opponent);
@@ -565,13 +587,6 @@ void Robo::update(const Robo& opponent)
     view_->follow(*this);
 }
 
-Sphere Robo::sphere() const
-{
-    Vector3 next_position(*(tree_->balance()));
-    next_position.add(delta_next_position_);
-    return Sphere(next_position, 1.0); // Cheating.  This is defined at json
-}
-
 void Robo::warp(const Vector3& to)
 {
     set_balance(tree_, collider_, to);
@@ -587,6 +602,8 @@ void Robo::was_shot(double damage)
     }
 }
 
+const WeaponProfile* Robo::weapon() const { return weapon_; }
+
 namespace
 {
 
@@ -611,12 +628,12 @@ bool is_sighting(   const Vector3& self_point,
     rotation.multiply(&to_opponent);
 
     // zero at (0, 0, -1)
-    const double theta_zx = normalize_angle(GameLib::atan2( to_opponent.x,
-                                                            to_opponent.z)
-                                            - 180.0);
-    const double theta_yz = normalize_angle(GameLib::atan2( to_opponent.z,
-                                                            to_opponent.y)
-                                            + 90.0);
+    const double theta_zx
+    = normalize_angle(Trigonometry::atan2(to_opponent.x, to_opponent.z)
+                        - 180.0);
+    const double theta_yz
+    = normalize_angle(Trigonometry::atan2(to_opponent.z, to_opponent.y)
+                        + 90.0);
 
     return std::abs(theta_zx) < abs_theta && std::abs(theta_yz) < abs_theta;
 }
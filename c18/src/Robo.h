@@ -9,11 +9,12 @@ namespace GameLib { class Texture; }
 namespace GraphicsDatabase { class Model; }
 namespace GraphicsDatabase { class Tree; }
 
-class Cuboid;
+class Capsule;
 class Segment;
 class Sphere;
 class Triangle;
 class View;
+class WeaponProfile;
 
 using GraphicsDatabase::Model;
 using GraphicsDatabase::Tree;
@@ -30,7 +31,8 @@ public:
 
 private:
     const std::string id_;
-    Tree* tree_;
+    Tree* tree_; // the balance and the angle
+    int pose_; // of the nodes
     Model* collider_;
     Vector3 force_;
     Vector3 velocity_;
@@ -39,6 +41,11 @@ private:
     double mass_;
     View* view_;
     WeaponState weapon_state_;
+    int weapon_index_; // in the loadout
+    const WeaponProfile* weapon_;
+    const WeaponProfile* homing_weapon_;
+    const WeaponProfile* defence_weapon_;
+    std::vector< int > threats_; // handles, kept for the next frames
     unsigned state_counter_;
     bool is_locking_on_;
     unsigned sighting_ms_;
@@ -65,26 +72,29 @@ public:
 
     void absorb_energy();
     void boost(const Vector3& direction);
+    Sphere bounding_sphere() const;
+    Capsule capsule() const;
     const Vector3* center() const;
-    Cuboid cuboid() const;
+    double collider_radius() const; // around the center
     void commit_next_position();
+    void defend(); // fires the defence weapon at the missiles coming in
     void draw(const View& view) const;
     void fire_bullet(const Robo* opponent);
     double get_half_sight_size_at_depth(const Robo& opponent) const;
     double get_lock_on_rate() const;
     double get_sight_depth(const Robo& opponent) const;
     void get_triangles(std::vector< Triangle >* triangles) const;
-    Cuboid locus_cuboid() const;
+    Segment locus_segment() const; // of the center, in the tick
     void print(std::ostringstream* oss) const;
     void rotate_zx(int angle_zx);
     void run(const Vector3& direction);
     Segment segment() const;
-    std::vector< Segment > segments() const;
     void set_model_angle_zx(double new_value);
-    Sphere sphere() const;
+    void switch_weapon(); // to the next one of the loadout
     void update(const Robo& opponent);
     void warp(const Vector3& to);
     void was_shot(double damage);
+    const WeaponProfile* weapon() const; // fired unless locking on
 
 private:
     void lock_on(const Robo& opponent);
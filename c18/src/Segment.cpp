@@ -32,11 +32,10 @@ Segment::~Segment() {}
 // GE * ED = u DE * ED + v EE * ED
 // GD * EE - GE * ED = u(DD * EE - DE * ED)
 // u = (GD * EE - GE * ED) / (DD * EE - DE * ED)
-std::pair< bool, Vector3 >
-Segment::get_intersected_point(const Triangle& triangle) const
+bool Segment::get_intersection(  const Triangle& triangle,
+                                double* t,
+                                Vector3* point) const
 {
-    Vector3 intersected_point(0.0, 0.0, 0.0);
-
     const Vector3& a = from;
 
     Vector3 b(to);
@@ -57,24 +56,24 @@ Segment::get_intersected_point(const Triangle& triangle) const
 
     if (bn == 0.0) // this means parallel
     {
-        return std::pair< bool, Vector3 >(false, intersected_point);
+        return false;
     }
 
     Vector3 ac(c);
     ac.subtract(a);
 
-    const double t = ac.dot(n) / bn;
+    *t = ac.dot(n) / bn;
 
-    if (t < 0.0 || t > 1.0)
+    if (*t < 0.0 || *t > 1.0)
     {
-        return std::pair< bool, Vector3 >(false, intersected_point);
+        return false;
     }
 
     Vector3 p(b);
-    p.multiply(t);
+    p.multiply(*t);
     p.add(a);
 
-    intersected_point = p; // do not confuse when got <false, p>, it is false
+    *point = p; // do not confuse when returned false, it is not on triangle
 
     Vector3 g(p);
     g.subtract(c);
@@ -91,7 +90,7 @@ Segment::get_intersected_point(const Triangle& triangle) const
 
     if (u < 0.0 || u > 1.0)
     {
-        return std::pair< bool, Vector3 >(false, intersected_point);
+        return false;
     }
 
     const double v = (gd * de - ge * dd) / (ed * de - ee * dd);
@@ -100,8 +99,158 @@ Segment::get_intersected_point(const Triangle& triangle) const
 
     if (v < 0.0 || uv > 1.0)
     {
-        return std::pair< bool, Vector3 >(false, intersected_point);
+        return false;
+    }
+
+    return true;
+}
+
+std::pair< bool, Vector3 >
+Segment::get_intersected_point(const Triangle& triangle) const
+{
+    double t = 0.0;
+    Vector3 intersected_point(0.0, 0.0, 0.0);
+    const bool does_intersect
+    = get_intersection(triangle, &t, &intersected_point);
+    return std::pair< bool, Vector3 >(does_intersect, intersected_point);
+}
+
+namespace
+{
+
+double clamp01(double a) { return a < 0.0 ? 0.0 : a > 1.0 ? 1.0 : a; }
+
+} // namespace -
+
+// this: p-> = a-> + s d1->, other: q-> = b-> + t d2->
+// minimize |p-> - q->| over s, t in [0, 1]
+double Segment::get_squared_distance(   const Segment& other,
+                                        Vector3* on_this,
+                                        Vector3* on_other) const
+{
+    Vector3 d1(to);
+    d1.subtract(from);
+
+    Vector3 d2(other.to);
+    d2.subtract(other.from);
+
+    Vector3 r(from);
+    r.subtract(other.from);
+
+    const double a = d1.dot(d1);
+    const double e = d2.dot(d2);
+    const double f = d2.dot(r);
+    double s = 0.0;
+    double t = 0.0;
+
+    if (a == 0.0 && e == 0.0)
+    {
+        s = 0.0;
+        t = 0.0;
+    }
+    else if (a == 0.0)
+    {
+        s = 0.0;
+        t = clamp01(f / e);
+    }
+    else
+    {
+        const double c = d1.dot(r);
+
+        if (e == 0.0)
+        {
+            t = 0.0;
+            s = clamp01(-c / a);
+        }
+        else
+        {
+            const double b = d1.dot(d2);
+            const double denominator = a * e - b * b;
+
+            // parallel segments leave s free, pick the start
+            s = (denominator != 0.0)
+            ? clamp01((b * f - c * e) / denominator)
+            : 0.0;
+            t = (b * s + f) / e;
+
+            if (t < 0.0)
+            {
+                t = 0.0;
+                s = clamp01(-c / a);
+            }
+            else if (t > 1.0)
+            {
+                t = 1.0;
+                s = clamp01((b - c) / a);
+            }
+        }
+    }
+
+    *on_this = d1;
+    on_this->multiply(s);
+    on_this->add(from);
+
+    *on_other = d2;
+    on_other->multiply(t);
+    on_other->add(other.from);
+
+    Vector3 diff(*on_this);
+    diff.subtract(*on_other);
+
+    return diff.squared_length();
+}
+
+double Segment::get_squared_distance(   const Triangle& triangle,
+                                        Vector3* on_this,
+                                        Vector3* on_triangle) const
+{
+    std::pair< bool, Vector3 > cp = get_intersected_point(triangle);
+
+    if (cp.first)
+    {
+        *on_this = cp.second;
+        *on_triangle = cp.second;
+        return 0.0;
+    }
+
+    // no crossing, so the closest pair lies on an end point of this
+    // segment or on an edge of the triangle
+    double min_distance = 0.0;
+    Vector3 p;
+    Vector3 q;
+
+    *on_this = from;
+    *on_triangle = triangle.get_closest_point(from);
+    Vector3 diff(*on_this);
+    diff.subtract(*on_triangle);
+    min_distance = diff.squared_length();
+
+    q = triangle.get_closest_point(to);
+    diff = to;
+    diff.subtract(q);
+
+    if (diff.squared_length() < min_distance)
+    {
+        min_distance = diff.squared_length();
+        *on_this = to;
+        *on_triangle = q;
+    }
+
+    const Segment edges[3] = {  Segment(triangle.p0, triangle.p1),
+                                Segment(triangle.p1, triangle.p2),
+                                Segment(triangle.p2, triangle.p0) };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const double distance = get_squared_distance(edges[i], &p, &q);
+
+        if (distance < min_distance)
+        {
+            min_distance = distance;
+            *on_this = p;
+            *on_triangle = q;
+        }
     }
 
-    return std::pair< bool, Vector3 >(true, intersected_point);
+    return min_distance;
 }
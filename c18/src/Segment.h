@@ -16,8 +16,17 @@ public:
 public:
     Segment(const Vector3& p0, const Vector3& p1);
     ~Segment();
+    bool get_intersection(  const Triangle& triangle,
+                            double* t,
+                            Vector3* point) const;
     std::pair< bool, Vector3 >
     get_intersected_point(const Triangle& triangle) const;
+    double get_squared_distance(    const Segment& other,
+                                    Vector3* on_this,
+                                    Vector3* on_other) const;
+    double get_squared_distance(    const Triangle& triangle,
+                                    Vector3* on_this,
+                                    Vector3* on_triangle) const;
 };
 
 #endif
@@ -0,0 +1,86 @@
+#include "Skeleton.h"
+#include <cassert>
+#include <string>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+#include "DataTree.h"
+
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+Vector3 get_vector(const DataTree& tree, int node, const Vector3& otherwise)
+{
+    if (node < 0)
+    {
+        return otherwise;
+    }
+
+    assert(tree.size(node) == 3);
+    return Vector3( tree.number(tree.at(node, 0)),
+                    tree.number(tree.at(node, 1)),
+                    tree.number(tree.at(node, 2)));
+}
+
+std::string get_string(const DataTree& tree, int node)
+{
+    return node < 0 ? std::string() : tree.string(node);
+}
+
+} // namespace -
+
+void Skeleton::load(const DataTree& tree, int node, Skeleton* skeleton)
+{
+    skeleton->id_ = tree.string(tree.find(node, "id"));
+    skeleton->add(tree, node, -1);
+}
+
+Skeleton::Skeleton()
+:   id_(), parents_(), model_ids_(), animation_ids_(),
+    positions_(), angles_(), scales_()
+{}
+
+Skeleton::~Skeleton() {}
+
+const Vector3& Skeleton::angle(int i) const { return angles_.at(i); }
+
+const std::string& Skeleton::animation_id(int i) const
+{
+    return animation_ids_.at(i);
+}
+
+const std::string& Skeleton::id() const { return id_; }
+
+const std::string& Skeleton::model_id(int i) const
+{
+    return model_ids_.at(i);
+}
+
+int Skeleton::parent(int i) const { return parents_.at(i); }
+
+const Vector3& Skeleton::position(int i) const { return positions_.at(i); }
+
+const Vector3& Skeleton::scale(int i) const { return scales_.at(i); }
+
+int Skeleton::size() const { return static_cast< int >(parents_.size()); }
+
+void Skeleton::add(const DataTree& tree, int node, int parent)
+{
+    const int index = size();
+    parents_.push_back(parent);
+    model_ids_.push_back(get_string(tree, tree.find(node, "model")));
+    animation_ids_.push_back(get_string(tree, tree.find(node, "animation")));
+    const Vector3 zero(0.0, 0.0, 0.0);
+    const Vector3 one(1.0, 1.0, 1.0);
+    positions_.push_back(get_vector(tree, tree.find(node, "position"), zero));
+    angles_.push_back(get_vector(tree, tree.find(node, "angle"), zero));
+    scales_.push_back(get_vector(tree, tree.find(node, "scale"), one));
+
+    const int children = tree.find(node, "children");
+
+    for (int i = 0; children >= 0 && i < tree.size(children); ++i)
+    {
+        add(tree, tree.at(children, i), index);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef ROBOFSKELETON_H_
+#define ROBOFSKELETON_H_
+#include <string>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+
+class DataTree;
+
+using GraphicsDatabase::Vector3;
+
+// An entry of "trees" in data/models.json, flattened in the depth first
+// order, so a parent is before its children.  The root is the node of the
+// tree itself, which has no model.  The scale of a node is of its model
+// only, the children are not scaled.
+class Skeleton
+{
+private:
+    std::string id_;
+    std::vector< int > parents_; // -1 for the root
+    std::vector< std::string > model_ids_; // empty if none
+    std::vector< std::string > animation_ids_; // empty if none
+    std::vector< Vector3 > positions_;
+    std::vector< Vector3 > angles_; // [degree]
+    std::vector< Vector3 > scales_;
+
+public:
+    static void load(const DataTree& tree, int node, Skeleton* skeleton);
+
+public:
+    Skeleton();
+    ~Skeleton();
+    const Vector3& angle(int i) const;
+    const std::string& animation_id(int i) const;
+    const std::string& id() const;
+    const std::string& model_id(int i) const;
+    int parent(int i) const;
+    const Vector3& position(int i) const;
+    const Vector3& scale(int i) const;
+    int size() const;
+
+private:
+    void add(const DataTree& tree, int node, int parent);
+};
+
+#endif
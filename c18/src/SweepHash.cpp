@@ -0,0 +1,155 @@
+#include "SweepHash.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "GraphicsDatabase/Vector3.h"
+
+using GraphicsDatabase::Vector3;
+
+SweepHash::SweepHash(double cell_size, int bucket_bits)
+:   cell_size_(cell_size),
+    bucket_mask_((1 << bucket_bits) - 1),
+    entries_(),
+    starts_((1 << bucket_bits) + 1, 0),
+    items_(),
+    stamps_(),
+    stamp_(0)
+{
+    assert(cell_size_ > 0.0);
+    assert(bucket_bits > 0 && bucket_bits < 24);
+}
+
+SweepHash::~SweepHash() {}
+
+// the segment is put in every cell its bounding box touches
+void SweepHash::add(int item, const Vector3& from, const Vector3& to)
+{
+    assert(item >= 0);
+
+    const int min_x = to_cell(std::min(from.x, to.x));
+    const int min_y = to_cell(std::min(from.y, to.y));
+    const int min_z = to_cell(std::min(from.z, to.z));
+    const int max_x = to_cell(std::max(from.x, to.x));
+    const int max_y = to_cell(std::max(from.y, to.y));
+    const int max_z = to_cell(std::max(from.z, to.z));
+
+    for (int x = min_x; x <= max_x; ++x)
+    {
+        for (int y = min_y; y <= max_y; ++y)
+        {
+            for (int z = min_z; z <= max_z; ++z)
+            {
+                Entry entry;
+                entry.bucket = get_bucket(x, y, z);
+                entry.item = item;
+                entries_.push_back(entry);
+            }
+        }
+    }
+
+    if (item >= static_cast< int >(stamps_.size()))
+    {
+        stamps_.resize(item + 1, 0);
+    }
+}
+
+// a counting sort by the bucket, O(entries + buckets)
+void SweepHash::build()
+{
+    std::fill(starts_.begin(), starts_.end(), 0);
+
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        starts_.at(entries_.at(i).bucket + 1)
+        = starts_.at(entries_.at(i).bucket + 1) + 1;
+    }
+
+    for (size_t i = 1; i < starts_.size(); ++i)
+    {
+        starts_.at(i) = starts_.at(i) + starts_.at(i - 1);
+    }
+
+    items_.resize(entries_.size());
+
+    // starts_[b] is used as the cursor of the bucket b, then shifted back
+    for (size_t i = 0; i < entries_.size(); ++i)
+    {
+        const int bucket = entries_.at(i).bucket;
+        items_.at(starts_.at(bucket)) = entries_.at(i).item;
+        starts_.at(bucket) = starts_.at(bucket) + 1;
+    }
+
+    for (size_t i = starts_.size() - 1; i > 0; --i)
+    {
+        starts_.at(i) = starts_.at(i - 1);
+    }
+
+    starts_.at(0) = 0;
+}
+
+void SweepHash::clear()
+{
+    entries_.clear();
+}
+
+size_t SweepHash::entries_size() const { return entries_.size(); }
+
+// appends each item once, returns how many buckets are visited
+int SweepHash::find(    const Vector3& from,
+                        const Vector3& to,
+                        std::vector< int >* found)
+{
+    const int min_x = to_cell(std::min(from.x, to.x));
+    const int min_y = to_cell(std::min(from.y, to.y));
+    const int min_z = to_cell(std::min(from.z, to.z));
+    const int max_x = to_cell(std::max(from.x, to.x));
+    const int max_y = to_cell(std::max(from.y, to.y));
+    const int max_z = to_cell(std::max(from.z, to.z));
+
+    stamp_ = stamp_ + 1;
+    int visited = 0;
+
+    for (int x = min_x; x <= max_x; ++x)
+    {
+        for (int y = min_y; y <= max_y; ++y)
+        {
+            for (int z = min_z; z <= max_z; ++z)
+            {
+                const int bucket = get_bucket(x, y, z);
+                const int end = starts_.at(bucket + 1);
+                ++visited;
+
+                for (int i = starts_.at(bucket); i < end; ++i)
+                {
+                    const int item = items_.at(i);
+
+                    if (stamps_.at(item) == stamp_)
+                    {
+                        continue;
+                    }
+
+                    stamps_.at(item) = stamp_;
+                    found->push_back(item);
+                }
+            }
+        }
+    }
+
+    return visited;
+}
+
+int SweepHash::get_bucket(int x, int y, int z) const
+{
+    const unsigned hash
+    = static_cast< unsigned >(x) * 73856093u
+    ^ static_cast< unsigned >(y) * 19349663u
+    ^ static_cast< unsigned >(z) * 83492791u;
+
+    return static_cast< int >(hash) & bucket_mask_;
+}
+
+int SweepHash::to_cell(double coordinate) const
+{
+    return static_cast< int >(std::floor(coordinate / cell_size_));
+}
@@ -0,0 +1,47 @@
+#ifndef ROBOFSWEEPHASH_H_
+#define ROBOFSWEEPHASH_H_
+#include <cstddef>
+#include <vector>
+
+namespace GraphicsDatabase { class Vector3; }
+
+using GraphicsDatabase::Vector3;
+
+// A spatial hash of the segments swept in a frame.  Add every segment, build
+// once, then find the candidates near another segment.  The arrays are kept
+// between the frames, so a rebuild does not allocate after the first ones.
+class SweepHash
+{
+private:
+    struct Entry
+    {
+        int bucket;
+        int item;
+    };
+
+private:
+    double cell_size_;
+    int bucket_mask_;
+    std::vector< Entry > entries_;
+    std::vector< int > starts_;
+    std::vector< int > items_;
+    std::vector< int > stamps_;
+    int stamp_;
+
+public:
+    SweepHash(double cell_size, int bucket_bits);
+    ~SweepHash();
+    void add(int item, const Vector3& from, const Vector3& to);
+    void build();
+    void clear();
+    size_t entries_size() const;
+    int find(   const Vector3& from,
+                const Vector3& to,
+                std::vector< int >* found);
+
+private:
+    int get_bucket(int x, int y, int z) const;
+    int to_cell(double coordinate) const;
+};
+
+#endif
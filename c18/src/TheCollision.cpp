@@ -3,330 +3,252 @@
 #include <vector>
 #include "GraphicsDatabase/Vector3.h"
 #include "Bullet.h"
-#include "Cuboid.h"
+#include "Capsule.h"
+#include "Hit.h"
 #include "Robo.h"
 #include "Segment.h"
-#include "Sphere.h"
 #include "TheHorizon.h"
 #include "Triangle.h"
 #include "Wall.h"
+#include "WeaponProfile.h"
 
 using GraphicsDatabase::Vector3;
 
-void TheCollision::burn(    Bullet* bullet,
-                            Robo* robo,
-                            const Cuboid& cuboid,
-                            const std::vector< Triangle >& triangles)
+namespace
 {
-    Cuboid bullet_cuboid = bullet->locus_cuboid();
-
-    if (!bullet_cuboid.does_intersect(cuboid))
-    {
-        return;
-    }
 
+// only records hits, TheHitQueue applies them after all passes
+void burn_by_triangles( Bullet* bullet,
+                        Robo* robo,
+                        const std::vector< Triangle >* triangles,
+                        std::vector< Hit >* hits)
+{
     Segment segment = bullet->locus_segment();
+    Vector3 direction(segment.to);
+    direction.subtract(segment.from);
+    double t = 0.0;
+    Vector3 at;
 
-    for (size_t i = 0; i < triangles.size(); ++i)
+    for (size_t i = 0; i < triangles->size(); ++i)
     {
-        std::pair< bool, Vector3 > cp
-        = segment.get_intersected_point(triangles.at(i));
-
-        if (cp.first)
+        if (!segment.get_intersection(triangles->at(i), &t, &at))
         {
-            bullet->burn_at(cp.second);
-            robo->was_shot(0.01);
+            continue;
         }
-    }
-}
-
-void TheCollision::burn(Bullet* bullet, TheHorizon horizon)
-{
-    Segment segment = bullet->locus_segment();
-    const std::vector< Triangle >* triangles = horizon.triangles();
 
-    for (size_t i = 0; i < triangles->size(); ++i)
-    {
-        std::pair< bool, Vector3 > cp
-        = segment.get_intersected_point(triangles->at(i));
+        Vector3 normal(triangles->at(i).normal());
 
-        if (cp.first)
+        if (normal.dot(direction) > 0.0)
         {
-            bullet->burn_at(cp.second);
+            normal.multiply(-1.0);
         }
-    }
-}
 
-void TheCollision::slide_next_move_if_collision_will_occur(Robo* robo)
-{
-    by_segment(robo);
+        hits->push_back(Hit(bullet->handle(), robo, at, normal, t));
+    }
 }
 
-void TheCollision::slide_next_move_if_collision_will_occur( Robo* robo,
-                                                            const Robo* opponent)
-{
-    by_sphere(robo, opponent);
-}
+} // namespace -
 
-void TheCollision::slide_next_move_if_collision_will_occur( Robo* robo,
-                                                            const Wall* wall)
+// Both move through the frame, so the closest approach is of the relative
+// motion, not of the two segments.  Both burn at the middle of them.
+bool TheCollision::burn(    Bullet* bullet,
+                            Bullet* other,
+                            std::vector< Hit >* hits)
 {
-    by_segment(robo, wall);
-}
+    const Segment a = bullet->locus_segment();
+    const Segment b = other->locus_segment();
 
-void TheCollision::by_cuboid(Robo* robo)
-{
-    Vector3 delta_next_position;
-    Vector3 velocity;
-
-    // TODO: skip for now, it make codes more long.
-    // patterns:
-    //   - x bad
-    //   - y bad
-    //   - z bad
-    //   - xy bad
-    //   - xz bad
-    //   - yz bad
-    //   - all bad
-
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
-
-    if (robo->cuboid().does_intersect(TheHorizon::instance().cuboid()))
-    {
-        delta_next_position.y = 0.0;
-        velocity.y = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
-    }
+    Vector3 d0(a.from);
+    d0.subtract(b.from);
+    Vector3 dv(a.to);
+    dv.subtract(a.from);
+    dv.add(b.from);
+    dv.subtract(b.to);
 
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
+    const double dv2 = dv.squared_length();
+    double t = dv2 > 0.0 ? -d0.dot(dv) / dv2 : 0.0;
+    t = t < 0.0 ? 0.0 : t > 1.0 ? 1.0 : t;
 
-    if (robo->cuboid().does_intersect(TheHorizon::instance().cuboid()))
-    {
-        delta_next_position.z = 0.0;
-        velocity.z = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
-    }
+    Vector3 gap(dv);
+    gap.multiply(t);
+    gap.add(d0);
 
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
+    const double reach = bullet->profile()->radius + other->profile()->radius;
 
-    if (robo->cuboid().does_intersect(TheHorizon::instance().cuboid()))
+    if (gap.squared_length() > reach * reach)
     {
-        delta_next_position.x = 0.0;
-        velocity.x = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
+        return false;
     }
-}
 
-void TheCollision::by_cuboid(Robo* robo, const Robo* opponent)
-{
-    Vector3 delta_next_position;
-    Vector3 velocity;
+    Vector3 at(a.to);
+    at.subtract(a.from);
+    at.multiply(t);
+    at.add(a.from);
+
+    Vector3 half_gap(gap);
+    half_gap.multiply(0.5);
+    at.subtract(half_gap);
 
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
+    Vector3 normal(gap);
 
-    if (robo->cuboid().does_intersect(opponent->cuboid()))
+    if (normal.squared_length() > 0.0)
     {
-        delta_next_position.z = 0.0;
-        velocity.z = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
+        normal.normalize(1.0);
     }
-
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
-
-    if (robo->cuboid().does_intersect(opponent->cuboid()))
+    else
     {
-        delta_next_position.x = 0.0;
-        velocity.x = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
+        normal.set(0.0, 1.0, 0.0);
     }
 
-    delta_next_position = *(robo->delta_next_position());
-    velocity = *(robo->velocity());
+    hits->push_back(Hit(bullet->handle(), 0, at, normal, t));
+    hits->push_back(Hit(other->handle(), 0, at, -normal, t));
 
-    if (robo->cuboid().does_intersect(opponent->cuboid()))
-    {
-        delta_next_position.y = 0.0;
-        velocity.y = 0.0;
-        robo->delta_next_position(delta_next_position);
-        robo->velocity(velocity);
-    }
+    return true;
 }
 
-void TheCollision::by_sphere(Robo* robo)
+void TheCollision::burn(    Bullet* bullet,
+                            Robo* robo,
+                            const Segment& locus,
+                            double radius,
+                            const std::vector< Triangle >& triangles,
+                            std::vector< Hit >* hits)
 {
-    Sphere rs(robo->sphere()); // robo sphere
-    Sphere hs(TheHorizon::instance().sphere()); // the horizon sphere
-
-    if (!rs.does_intersect(hs))
+    // the robo swept as a sphere, around the moves of both
+    const Segment bullet_locus = bullet->locus_segment();
+    Vector3 on_bullet;
+    Vector3 on_robo;
+    const double squared_distance
+    = bullet_locus.get_squared_distance(locus, &on_bullet, &on_robo);
+
+    if (squared_distance > radius * radius)
     {
         return;
     }
 
-    Vector3 d(*(robo->delta_next_position())); // delta
-
-    Vector3 to_the_horizon(*(hs.balance()));
-    to_the_horizon.subtract(*(rs.balance()));
-    double length = to_the_horizon.length();
-    to_the_horizon.multiply(to_the_horizon.dot(d));
-    to_the_horizon.divide(length * length);
-
-    d.subtract(to_the_horizon);
-
-    robo->delta_next_position(d);
-
-    Vector3 v(*(robo->velocity()));
-    to_the_horizon = *(hs.balance());
-    to_the_horizon.subtract(*(rs.balance()));
-    length = to_the_horizon.length();
-    to_the_horizon.multiply(to_the_horizon.dot(v));
-    to_the_horizon.divide(length * length);
-
-    v.subtract(to_the_horizon);
-
-    robo->velocity(v);
+    burn_by_triangles(bullet, robo, &triangles, hits);
 }
 
-namespace
+void TheCollision::burn(    Bullet* bullet,
+                            TheHorizon horizon,
+                            std::vector< Hit >* hits)
 {
+    burn_by_triangles(bullet, 0, horizon.triangles(), hits);
+}
 
-bool does_theta_greater_than_90(const Vector3& a, const Vector3& b)
+void TheCollision::slide_next_move_if_collision_will_occur(Robo* robo)
 {
-    Vector3 normalized_a(a);
-    normalized_a.normalize(1.0);
-    Vector3 normalized_b(b);
-    normalized_b.normalize(1.0);
-    normalized_a.add(normalized_b);
-    return normalized_a.squared_length() < 2.0;
+    by_capsule(robo);
 }
 
-} // namespace -
-
-void TheCollision::by_sphere(Robo* robo, const Robo* opponent)
+void TheCollision::slide_next_move_if_collision_will_occur( Robo* robo,
+                                                            const Robo* opponent)
 {
-    Sphere rs(robo->sphere()); // robo sphere
-    Sphere os(opponent->sphere()); // opponent sphere
+    by_capsule(robo, opponent);
+}
 
-    if (!rs.does_intersect(os))
-    {
-        return;
-    }
+void TheCollision::slide_next_move_if_collision_will_occur( Robo* robo,
+                                                            const Wall* wall)
+{
+    by_capsule(robo, wall);
+}
 
-    Vector3 d(*(robo->delta_next_position())); // delta
+namespace
+{
 
-    Vector3 to_the_opponent(*(os.balance()));
-    to_the_opponent.subtract(*(rs.balance()));
+// removes the part of the vector which goes into the surface
+Vector3 get_slid(const Vector3& a, const Vector3& normal)
+{
+    const double into = a.dot(normal);
 
-    if (does_theta_greater_than_90(d, to_the_opponent))
+    if (into >= 0.0)
     {
-        return;
+        return a;
     }
 
-    double length = to_the_opponent.length();
-    to_the_opponent.multiply(to_the_opponent.dot(d));
-    to_the_opponent.divide(length * length);
-
-    d.subtract(to_the_opponent);
+    Vector3 into_surface(normal);
+    into_surface.multiply(into);
 
-    robo->delta_next_position(d);
+    Vector3 slid(a);
+    slid.subtract(into_surface);
+    return slid;
+}
 
-    Vector3 v(*(robo->velocity()));
-    to_the_opponent = *(os.balance());
-    to_the_opponent.subtract(*(rs.balance()));
-    length = to_the_opponent.length();
-    to_the_opponent.multiply(to_the_opponent.dot(v));
-    to_the_opponent.divide(length * length);
+// moves until the time of impact, then slides the rest of the move
+void slide(Robo* robo, double t, const Vector3& normal)
+{
+    Vector3 before(*(robo->delta_next_position()));
+    before.multiply(t);
 
-    v.subtract(to_the_opponent);
+    Vector3 after(*(robo->delta_next_position()));
+    after.multiply(1.0 - t);
+    after = get_slid(after, normal);
+    after.add(before);
 
-    robo->velocity(v);
+    robo->delta_next_position(after);
+    robo->velocity(get_slid(*(robo->velocity()), normal));
+    robo->force(get_slid(*(robo->force()), normal));
 }
 
-namespace
-{
-
 void robo_to_triangles(Robo* robo, const std::vector< Triangle >* triangles)
 {
-    const std::vector< Segment > segments = robo->segments();
-    std::vector< Segment >::const_iterator it = segments.begin();
-    std::pair< bool, Vector3 > collision_point(false, Vector3(0.0, 0.0, 0.0));
+    const Capsule capsule = robo->capsule();
+    const Vector3* delta = robo->delta_next_position();
+    bool did_hit = false;
+    double earliest_t = 1.0;
+    Vector3 earliest_normal;
+    double t = 0.0;
+    Vector3 normal;
 
     for (size_t i = 0; i < triangles->size(); ++i)
     {
-        for (it = segments.begin(); it != segments.end(); ++it)
+        if (!capsule.sweep(*delta, triangles->at(i), &t, &normal))
         {
-            collision_point = (*it).get_intersected_point(triangles->at(i));
-
-            if (collision_point.first)
-            {
-                break;
-            }
+            continue;
         }
 
-        if (collision_point.first)
+        if (!did_hit || t < earliest_t)
         {
-            break;
+            did_hit = true;
+            earliest_t = t;
+            earliest_normal = normal;
         }
     }
 
-    if (!collision_point.first)
+    if (!did_hit)
     {
         return;
     }
 
-    const Vector3* balance = robo->center();
-    Vector3 to_collision_point(collision_point.second);
-    to_collision_point.subtract(*balance);
-
-    const Vector3* force = robo->force();
-    double cosine = force->dot(to_collision_point)
-    / (force->length() * to_collision_point.length());
-    Vector3 delta(*force);
-    delta.multiply(cosine);
-
-    Vector3 new_value(*force);
-    new_value.subtract(delta);
-    robo->force(new_value);
-
-    const Vector3* velocity = robo->velocity();
-    cosine = velocity->dot(to_collision_point)
-    / (velocity->length() * to_collision_point.length());
-    delta = *velocity;
-    delta.multiply(cosine);
-
-    new_value = *velocity;
-    new_value.subtract(delta);
-    robo->velocity(new_value);
-
-    const Vector3* delta_next_position = robo->delta_next_position();
-    cosine = delta_next_position->dot(to_collision_point)
-    / (delta_next_position->length() * to_collision_point.length());
-    delta = *delta_next_position;
-    delta.multiply(cosine);
-
-    new_value = *delta_next_position;
-    new_value.subtract(delta);
-    robo->delta_next_position(new_value);
+    slide(robo, earliest_t, earliest_normal);
 }
 
 } // namespace -
 
-void TheCollision::by_segment(Robo* robo)
+void TheCollision::by_capsule(Robo* robo)
 {
     const std::vector< Triangle >* triangles = TheHorizon::instance().triangles();
     robo_to_triangles(robo, triangles);
 }
 
-void TheCollision::by_segment(Robo* robo, const Wall* wall)
+void TheCollision::by_capsule(Robo* robo, const Robo* opponent)
+{
+    // sweep in the opponent's frame, it moves as well in this tick
+    Vector3 relative_delta(*(robo->delta_next_position()));
+    relative_delta.subtract(*(opponent->delta_next_position()));
+
+    const Capsule capsule = robo->capsule();
+    double t = 0.0;
+    Vector3 normal;
+
+    if (!capsule.sweep(relative_delta, opponent->capsule(), &t, &normal))
+    {
+        return;
+    }
+
+    slide(robo, t, normal);
+}
+
+void TheCollision::by_capsule(Robo* robo, const Wall* wall)
 {
     const std::vector< Triangle >* triangles = wall->triangles();
     robo_to_triangles(robo, triangles);
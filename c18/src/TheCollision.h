@@ -3,8 +3,9 @@
 #include <vector>
 
 class Bullet;
-class Cuboid;
+class Hit;
 class Robo;
+class Segment;
 class TheHorizon;
 class Triangle;
 class Wall;
@@ -12,11 +13,18 @@ class Wall;
 class TheCollision
 {
 public:
+    static bool burn(   Bullet* bullet,
+                        Bullet* other,
+                        std::vector< Hit >* hits);
     static void burn(   Bullet* bullet,
                         Robo* robo,
-                        const Cuboid& cuboid,
-                        const std::vector< Triangle >& triangles);
-    static void burn(Bullet* bullet, TheHorizon horizon);
+                        const Segment& locus,
+                        double radius,
+                        const std::vector< Triangle >& triangles,
+                        std::vector< Hit >* hits);
+    static void burn(   Bullet* bullet,
+                        TheHorizon horizon,
+                        std::vector< Hit >* hits);
     static void slide_next_move_if_collision_will_occur(Robo* robo);
     static void slide_next_move_if_collision_will_occur(    Robo* robo,
                                                             const Robo* opponent);
@@ -24,12 +32,9 @@ public:
                                                             const Wall* wall);
 
 private:
-    static void by_cuboid(Robo* robo);
-    static void by_cuboid(Robo* robo, const Robo* opponent);
-    static void by_sphere(Robo* robo);
-    static void by_sphere(Robo* robo, const Robo* opponent);
-    static void by_segment(Robo* robo);
-    static void by_segment(Robo* robo, const Wall* wall);
+    static void by_capsule(Robo* robo);
+    static void by_capsule(Robo* robo, const Robo* opponent);
+    static void by_capsule(Robo* robo, const Wall* wall);
 };
 
 #endif
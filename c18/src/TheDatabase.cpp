@@ -1,8 +1,10 @@
 #include "TheDatabase.h"
 #include <cassert>
+#include <vector>
 #include "GraphicsDatabase/Database.h"
 #include "GraphicsDatabase/Model.h"
 #include "GraphicsDatabase/Tree.h"
+#include "WeaponProfile.h"
 
 using GraphicsDatabase::Database;
 using GraphicsDatabase::Model;
@@ -15,6 +17,7 @@ class Impl
 {
 private:
     Database* db_;
+    std::vector< WeaponProfile > weapons_;
 
 public:
     Impl();
@@ -24,12 +27,14 @@ public:
                         const std::string& batch_id);
     Model* find_model(const std::string& id);
     Tree* find(const std::string& id);
+    const WeaponProfile* find_weapon(const std::string& id) const;
 };
 
 Impl::Impl()
-: db_(0)
+: db_(0), weapons_()
 {
     db_ = new Database("data/models.json");
+    WeaponProfile::load("data/weapons.json", &weapons_);
 }
 
 Impl::~Impl()
@@ -53,6 +58,19 @@ Tree* Impl::find(const std::string& id) { return db_->find_tree(id); }
 
 Model* Impl::find_model(const std::string& id) { return db_->find(id); }
 
+const WeaponProfile* Impl::find_weapon(const std::string& id) const
+{
+    for (size_t i = 0; i < weapons_.size(); ++i)
+    {
+        if (weapons_.at(i).id == id)
+        {
+            return &weapons_.at(i);
+        }
+    }
+
+    return 0;
+}
+
 Impl* g_impl = 0;
 
 } // namespace -
@@ -99,3 +117,8 @@ Model* TheDatabase::find_model(const std::string& id) const
 {
     return g_impl->find_model(id);
 }
+
+const WeaponProfile* TheDatabase::find_weapon(const std::string& id) const
+{
+    return g_impl->find_weapon(id);
+}
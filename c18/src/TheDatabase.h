@@ -5,6 +5,8 @@
 namespace GraphicsDatabase { class Model; }
 namespace GraphicsDatabase { class Tree; }
 
+class WeaponProfile;
+
 using GraphicsDatabase::Model;
 using GraphicsDatabase::Tree;
 
@@ -26,6 +28,7 @@ public:
                         const std::string& batch_id) const;
     Model* find_model(const std::string& id) const;
     Tree* find(const std::string& id) const;
+    const WeaponProfile* find_weapon(const std::string& id) const;
 };
 
 #endif
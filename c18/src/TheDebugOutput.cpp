@@ -1,51 +1,139 @@
 #include "TheDebugOutput.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <sstream>
-#include "GameLib/Framework.h"
+#include "Ai/TheArmoury.h"
+#include "Animation.h"
+#include "Frustum.h"
+#include "Platform.h"
 #include "Robo.h"
+#include "TheDrawQueue.h"
+#include "TheFrontend.h"
+#include "ThePoses.h"
 #include "Triangle.h"
 #include "View.h"
 
+namespace
+{
+
+const int MaxLines = 48;
+const int LineSize = 128; // with the terminator, longer ones are cut
+
+const char* const StatFormats[TheDebugOutput::StatSize] = {
+    "frame: %.1f ms",
+    "bullets: %.0f",
+    "collision tests: %.0f" };
+
+char g_lines[MaxLines][LineSize];
+char g_stat_lines[TheDebugOutput::StatSize][LineSize];
+double g_stats[TheDebugOutput::StatSize];
+bool g_is_stat_set[TheDebugOutput::StatSize];
+int g_changed_count = 0; // lines, in the frame
+
+// The objects print to a stream, so one stream is kept for them.  It can
+// be read as well; it is rewound rather than emptied, since str() of some
+// libraries frees the buffer, and only the characters written are read.
+std::ostringstream g_stream(std::ios_base::in);
+
+void set_line(int row, const char* line, size_t size)
+{
+    if (row >= MaxLines)
+    {
+        return;
+    }
+
+    size = size < LineSize - 1 ? size : LineSize - 1;
+
+    if (std::strncmp(g_lines[row], line, size) == 0
+        && g_lines[row][size] == '\0')
+    {
+        return;
+    }
+
+    std::memcpy(g_lines[row], line, size);
+    g_lines[row][size] = '\0';
+    g_changed_count = g_changed_count + 1;
+}
+
+} // namespace -
+
 int TheDebugOutput::row = 0;
 
-void TheDebugOutput::clear() { TheDebugOutput::row = 0; }
+void TheDebugOutput::clear()
+{
+    TheDebugOutput::row = 0;
+    g_changed_count = 0;
+}
+
+void TheDebugOutput::flush()
+{
+    int stat_rows = 0;
+
+    for (int i = 0; i < StatSize && ROBOF_PINNED_STATS; ++i)
+    {
+        if (g_is_stat_set[i])
+        {
+            Platform::draw_string(0, stat_rows, g_stat_lines[i]);
+            ++stat_rows;
+        }
+    }
+
+    for (int i = 0; i < row && i < MaxLines; ++i)
+    {
+        Platform::draw_string(0, stat_rows + i, g_lines[i]);
+    }
+}
+
+// formatted only when the value changes
+void TheDebugOutput::pin(Stat stat, double value)
+{
+    if (g_is_stat_set[stat] && g_stats[stat] == value)
+    {
+        return;
+    }
+
+    std::snprintf(   g_stat_lines[stat],
+                    sizeof(g_stat_lines[stat]),
+                    StatFormats[stat],
+                    value);
+    g_stats[stat] = value;
+    g_is_stat_set[stat] = true;
+}
 
 void TheDebugOutput::print(const unsigned& a)
 {
-    std::ostringstream oss;
-    oss << a;
+    char line[LineSize];
+    const int size = std::snprintf(line, sizeof(line), "%u", a);
 
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.drawDebugString(0, row, oss.str().c_str());
+    set_line(row, line, size);
 
     ++row;
 }
 
 void TheDebugOutput::print(const int& a)
 {
-    std::ostringstream oss;
-    oss << a;
+    char line[LineSize];
+    const int size = std::snprintf(line, sizeof(line), "%d", a);
 
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.drawDebugString(0, row, oss.str().c_str());
+    set_line(row, line, size);
 
     ++row;
 }
 
 void TheDebugOutput::print(const double& a)
 {
-    std::ostringstream oss;
-    oss << a;
+    char line[LineSize];
+    const int size = std::snprintf(line, sizeof(line), "%g", a);
 
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.drawDebugString(0, row, oss.str().c_str());
+    set_line(row, line, size);
 
     ++row;
 }
 
 void TheDebugOutput::print(const char* string)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.drawDebugString(0, row, string);
+    set_line(row, string, std::strlen(string));
 
     ++row;
 }
@@ -53,15 +141,29 @@ void TheDebugOutput::print(const char* string)
 template< class T >
 void TheDebugOutput::print(const T& some)
 {
-    std::ostringstream oss;
-    some.print(&oss);
+    g_stream.clear();
+    g_stream.seekp(0);
+    some.print(&g_stream);
+
+    const std::streamoff written = std::max< std::streamoff >(
+        0, g_stream.tellp());
+    const std::streamsize size = std::min< std::streamoff >(
+        written, LineSize - 1);
+    char line[LineSize];
+    g_stream.rdbuf()->pubseekpos(0, std::ios_base::in);
+    g_stream.rdbuf()->sgetn(line, size);
 
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.drawDebugString(0, row, oss.str().c_str());
+    set_line(row, line, static_cast< size_t >(size));
 
     ++row;
 }
 
+template void TheDebugOutput::print(const Ai::TheArmoury&);
+template void TheDebugOutput::print(const Animation&);
+template void TheDebugOutput::print(const Frustum&);
+template void TheDebugOutput::print(const TheDrawQueue&);
+template void TheDebugOutput::print(const TheFrontend&);
+template void TheDebugOutput::print(const ThePoses&);
 template void TheDebugOutput::print(const Robo&);
 template void TheDebugOutput::print(const Triangle&);
 template void TheDebugOutput::print(const View&);
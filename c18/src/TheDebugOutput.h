@@ -4,13 +4,27 @@
 class Robo;
 class Triangle;
 
+// The lines of a frame are formatted into a fixed buffer, which is kept
+// from frame to frame, so a line is copied only when it changes.  They
+// are drawn at once by flush, under the pinned stats.
 class TheDebugOutput
 {
+public:
+    enum Stat
+    {
+        StatFrameMs,
+        StatBulletsLive,
+        StatCollisionTests,
+        StatSize
+    };
+
 private:
     static int row;
 
 public:
     static void clear();
+    static void flush(); // once a frame, before the end of it
+    static void pin(Stat stat, double value);
     static void print(const unsigned& a);
     static void print(const int& a);
     static void print(const double& a);
@@ -19,4 +33,15 @@ public:
     static void print(const T& some);
 };
 
+// 1 to draw the pinned stats, on in the release builds too
+#ifndef ROBOF_PINNED_STATS
+#define ROBOF_PINNED_STATS 1
+#endif
+
+// 1 to print the lines of the objects of the game from the start, else
+// they are off till the debug key turns them on
+#ifndef ROBOF_DEBUG_LINES
+#define ROBOF_DEBUG_LINES 0
+#endif
+
 #endif
@@ -0,0 +1,385 @@
+#include "TheDrawQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <vector>
+#include "Platform.h"
+
+namespace
+{
+
+const size_t ReservedTriangles = 4096;
+
+} // namespace -
+
+namespace
+{
+
+struct State
+{
+    GameLib::Texture* texture;
+    const Image* image;
+    TheDrawQueue::BlendMode blend_mode;
+    bool does_test_depth;
+    bool does_write_depth;
+
+    State();
+    bool operator==(const State& other) const;
+};
+
+State::State()
+:   texture(0),
+    image(0),
+    blend_mode(TheDrawQueue::BlendLinear),
+    does_test_depth(true),
+    does_write_depth(true)
+{
+}
+
+bool State::operator==(const State& other) const
+{
+    return texture == other.texture
+        && image == other.image
+        && blend_mode == other.blend_mode
+        && does_test_depth == other.does_test_depth
+        && does_write_depth == other.does_write_depth;
+}
+
+// a copy of the arguments of Framework::drawTriangle3DH
+struct Command
+{
+    double vertexes[3][4];
+    double uvs[3][2];
+    bool has_uvs;
+    unsigned colors[3];
+    int state;
+};
+
+class Impl
+{
+private:
+    std::vector< State > states_;
+    State current_;
+    int current_index_;
+    std::vector< Command > commands_;
+    std::vector< int > sorted_;
+    int triangle_count_;
+    int batch_count_;
+    int unsorted_batch_count_;
+    int state_change_count_;
+
+public:
+    Impl();
+    ~Impl();
+    void add_triangle(  const double* p0,
+                        const double* p1,
+                        const double* p2,
+                        const double* t0,
+                        const double* t1,
+                        const double* t2,
+                        unsigned c0,
+                        unsigned c1,
+                        unsigned c2);
+    void blend_mode(TheDrawQueue::BlendMode mode);
+    void enable_depth_test(bool does_test);
+    void enable_depth_write(bool does_write);
+    void flush();
+    void print(std::ostringstream* oss) const;
+    void texture(GameLib::Texture* texture, const Image* image);
+
+private:
+    int find_state();
+    void set_state(const State& state, const State* last);
+};
+
+Impl::Impl()
+:   states_(), current_(), current_index_(-1),
+    commands_(), sorted_(),
+    triangle_count_(0), batch_count_(0), unsorted_batch_count_(0),
+    state_change_count_(0)
+{
+    commands_.reserve(ReservedTriangles);
+    sorted_.reserve(ReservedTriangles);
+}
+
+Impl::~Impl() {}
+
+void Impl::add_triangle(    const double* p0,
+                            const double* p1,
+                            const double* p2,
+                            const double* t0,
+                            const double* t1,
+                            const double* t2,
+                            unsigned c0,
+                            unsigned c1,
+                            unsigned c2)
+{
+    if (current_index_ < 0)
+    {
+        current_index_ = find_state();
+    }
+
+    commands_.push_back(Command());
+    Command& command = commands_.back();
+    const double* const ps[3] = { p0, p1, p2 };
+    const double* const ts[3] = { t0, t1, t2 };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        std::copy(ps[i], ps[i] + 4, command.vertexes[i]);
+    }
+
+    command.has_uvs = t0 && t1 && t2;
+
+    for (int i = 0; i < 3 && command.has_uvs; ++i)
+    {
+        std::copy(ts[i], ts[i] + 2, command.uvs[i]);
+    }
+
+    command.colors[0] = c0;
+    command.colors[1] = c1;
+    command.colors[2] = c2;
+    command.state = current_index_;
+}
+
+void Impl::blend_mode(TheDrawQueue::BlendMode mode)
+{
+    assert(mode >= 0 && mode < TheDrawQueue::BlendModeSize);
+    current_.blend_mode = mode;
+    current_index_ = -1;
+}
+
+void Impl::enable_depth_test(bool does_test)
+{
+    current_.does_test_depth = does_test;
+    current_index_ = -1;
+}
+
+void Impl::enable_depth_write(bool does_write)
+{
+    current_.does_write_depth = does_write;
+    current_index_ = -1;
+}
+
+// A frame has a few states, so a linear search is enough.
+int Impl::find_state()
+{
+    for (size_t i = 0; i < states_.size(); ++i)
+    {
+        if (states_.at(i) == current_)
+        {
+            return static_cast< int >(i);
+        }
+    }
+
+    states_.push_back(current_);
+    return static_cast< int >(states_.size()) - 1;
+}
+
+namespace
+{
+
+// The same states have the same index, so the opaque ones are grouped by
+// the index.  The others are all equal here, and the stable sort keeps
+// their order.
+class IsBefore
+{
+private:
+    const std::vector< Command >* commands_;
+    const std::vector< State >* states_;
+
+public:
+    IsBefore(   const std::vector< Command >* commands,
+                const std::vector< State >* states)
+    :   commands_(commands), states_(states)
+    {
+    }
+
+    bool operator()(int a, int b) const
+    {
+        const int state_a = commands_->at(a).state;
+        const int state_b = commands_->at(b).state;
+        const bool is_opaque_a = states_->at(state_a).does_write_depth;
+        const bool is_opaque_b = states_->at(state_b).does_write_depth;
+
+        if (is_opaque_a != is_opaque_b)
+        {
+            return is_opaque_a;
+        }
+
+        return is_opaque_a && state_a < state_b;
+    }
+};
+
+} // namespace -
+
+void Impl::flush()
+{
+    triangle_count_ = static_cast< int >(commands_.size());
+    batch_count_ = 0;
+    unsorted_batch_count_ = 0;
+    state_change_count_ = 0;
+
+    sorted_.clear();
+
+    for (int i = 0; i < triangle_count_; ++i)
+    {
+        sorted_.push_back(i);
+
+        if (i == 0 || commands_.at(i).state != commands_.at(i - 1).state)
+        {
+            unsorted_batch_count_ = unsorted_batch_count_ + 1;
+        }
+    }
+
+    std::stable_sort(   sorted_.begin(),
+                        sorted_.end(),
+                        IsBefore(&commands_, &states_));
+
+    int last_state = -1;
+
+    for (int i = 0; i < triangle_count_; ++i)
+    {
+        const Command& command = commands_.at(sorted_.at(i));
+
+        if (command.state != last_state)
+        {
+            set_state(  states_.at(command.state),
+                        last_state < 0 ? 0 : &states_.at(last_state));
+            last_state = command.state;
+            batch_count_ = batch_count_ + 1;
+        }
+
+        Platform::draw_triangle(    command.vertexes[0],
+                                    command.vertexes[1],
+                                    command.vertexes[2],
+                                    command.has_uvs ? command.uvs[0] : 0,
+                                    command.has_uvs ? command.uvs[1] : 0,
+                                    command.has_uvs ? command.uvs[2] : 0,
+                                    command.colors[0],
+                                    command.colors[1],
+                                    command.colors[2]);
+    }
+
+    // the states of the next frame start from the default ones, so do the
+    // ones of the models drawn directly
+    const State default_state;
+    set_state(default_state, last_state < 0 ? 0 : &states_.at(last_state));
+
+    commands_.clear();
+    states_.clear();
+    current_ = default_state;
+    current_index_ = -1;
+}
+
+void Impl::print(std::ostringstream* oss) const
+{
+    *oss << "triangles: ";
+    *oss << triangle_count_;
+    *oss << ", batches: ";
+    *oss << batch_count_;
+    *oss << " (unsorted ";
+    *oss << unsorted_batch_count_;
+    *oss << "), state changes: ";
+    *oss << state_change_count_;
+}
+
+// sets only the ones which differ from the last, all of them without it
+void Impl::set_state(const State& state, const State* last)
+{
+    if (!last || last->texture != state.texture || last->image != state.image)
+    {
+        Platform::texture(state.texture, state.image);
+        state_change_count_ = state_change_count_ + 1;
+    }
+
+    if (!last || last->blend_mode != state.blend_mode)
+    {
+        Platform::blend_mode(state.blend_mode);
+        state_change_count_ = state_change_count_ + 1;
+    }
+
+    if (!last || last->does_test_depth != state.does_test_depth)
+    {
+        Platform::enable_depth_test(state.does_test_depth);
+        state_change_count_ = state_change_count_ + 1;
+    }
+
+    if (!last || last->does_write_depth != state.does_write_depth)
+    {
+        Platform::enable_depth_write(state.does_write_depth);
+        state_change_count_ = state_change_count_ + 1;
+    }
+}
+
+void Impl::texture(GameLib::Texture* texture, const Image* image)
+{
+    current_.texture = texture;
+    current_.image = image;
+    current_index_ = -1;
+}
+
+Impl* g_impl = 0;
+
+} // namespace -
+
+void TheDrawQueue::create()
+{
+    assert(!g_impl);
+    g_impl = new Impl();
+}
+
+void TheDrawQueue::destroy()
+{
+    assert(g_impl);
+    delete g_impl;
+    g_impl = 0;
+}
+
+TheDrawQueue TheDrawQueue::instance() { return TheDrawQueue(); }
+
+bool TheDrawQueue::did_create() { return !!g_impl; }
+
+TheDrawQueue::TheDrawQueue() {}
+
+TheDrawQueue::~TheDrawQueue() {}
+
+void TheDrawQueue::add_triangle(    const double* p0,
+                                    const double* p1,
+                                    const double* p2,
+                                    const double* t0,
+                                    const double* t1,
+                                    const double* t2,
+                                    unsigned c0,
+                                    unsigned c1,
+                                    unsigned c2) const
+{
+    g_impl->add_triangle(p0, p1, p2, t0, t1, t2, c0, c1, c2);
+}
+
+void TheDrawQueue::blend_mode(BlendMode mode) const
+{
+    g_impl->blend_mode(mode);
+}
+
+void TheDrawQueue::enable_depth_test(bool does_test) const
+{
+    g_impl->enable_depth_test(does_test);
+}
+
+void TheDrawQueue::enable_depth_write(bool does_write) const
+{
+    g_impl->enable_depth_write(does_write);
+}
+
+void TheDrawQueue::flush() const { g_impl->flush(); }
+
+void TheDrawQueue::print(std::ostringstream* oss) const
+{
+    g_impl->print(oss);
+}
+
+void TheDrawQueue::texture(GameLib::Texture* texture, const Image* image) const
+{
+    g_impl->texture(texture, image);
+}
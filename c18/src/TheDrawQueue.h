@@ -0,0 +1,54 @@
+#ifndef ROBOFTHEDRAWQUEUE_H_
+#define ROBOFTHEDRAWQUEUE_H_
+#include <sstream>
+
+namespace GameLib { class Texture; }
+class Image;
+
+// The triangles of a frame, recorded with the texture, the blend and the
+// depth states they are drawn with, then flushed at the end of the frame
+// sorted by the states, so a run of the same states is one batch.  The
+// opaque ones, which write the depth, go first in any order; the others
+// keep the order they were added in, as blending depends on it.  They go
+// to the renderer of the platform.
+class TheDrawQueue
+{
+public:
+    enum BlendMode
+    {
+        BlendLinear,
+        BlendAdditive,
+        BlendOpaque,
+        BlendModeSize
+    };
+
+public:
+    static void create();
+    static void destroy();
+    static TheDrawQueue instance();
+    static bool did_create();
+
+private:
+    TheDrawQueue();
+
+public:
+    ~TheDrawQueue();
+    void add_triangle(  const double* p0,
+                        const double* p1,
+                        const double* p2,
+                        const double* t0 = 0,
+                        const double* t1 = 0,
+                        const double* t2 = 0,
+                        unsigned c0 = 0xffffffff,
+                        unsigned c1 = 0xffffffff,
+                        unsigned c2 = 0xffffffff) const;
+    void blend_mode(BlendMode mode) const;
+    void enable_depth_test(bool does_test) const;
+    void enable_depth_write(bool does_write) const;
+    void flush() const;
+    void print(std::ostringstream* oss) const;
+    // the image is what a software renderer samples for the texture
+    void texture(GameLib::Texture* texture, const Image* image = 0) const;
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 const unsigned TheEnvironment::MaxBattleMs          = 99000;
 double TheEnvironment::FollowRate                   = 0.2;
+bool TheEnvironment::DoesInterceptBullets           = true;
 const double TheEnvironment::GravityAcceleration    = 9.8;
 unsigned TheEnvironment::RemainedBattleMs           = MaxBattleMs;
 const double TheEnvironment::AmbientBrightness      = 0.2;
@@ -10,6 +10,7 @@ class TheEnvironment
 public:
     static const unsigned MaxBattleMs;
     static double FollowRate;
+    static bool DoesInterceptBullets;
     static const double GravityAcceleration;
     static unsigned RemainedBattleMs;
     static const double AmbientBrightness;
@@ -1,13 +1,17 @@
 #include "TheFrontend.h"
 #include <cassert>
 #include <cmath>
+#include <sstream>
 #include <utility>
-#include "GameLib/Framework.h"
+#include <vector>
 #include "GameLib/Math.h"
 #include "GraphicsDatabase/Matrix44.h"
 #include "GraphicsDatabase/Vector3.h"
 #include "Robo.h"
+#include "Radar.h"
+#include "TheDrawQueue.h"
 #include "TheEnvironment.h"
+#include "TheTime.h"
 #include "View.h"
 
 using std::pair;
@@ -17,46 +21,64 @@ using GraphicsDatabase::Vector3;
 namespace
 {
 
-void draw_rect( pair< double, double > p0,
+enum ElementId
+{
+    ElementTimeBar,
+    ElementEnergyBar,
+    ElementHpBar,
+    ElementOpponentHpBar,
+    ElementLockOnSight,
+    ElementRadarFrame,
+    ElementRadarPlayer,
+    ElementSize
+};
+
+const int QuadCounts[ElementSize] = { 1, 1, 1, 1, 4, 4, 1 };
+const int MaxInputs = 4;
+
+const pair< double, double > RadarCenter(0.825, 0.675);
+const double RadarHalfSize = 0.125;
+const unsigned RadarColorFrom = 0xea140cdc;
+const unsigned RadarColorTo = 0xeadc0c0c;
+const int RadarColorSteps = 32; // of the height of a blip
+const double RadarRange = 100.0; // [m], exact within, at the edge beyond
+const double RadarScaleLength = 20.0; // [m], to the edge of the map
+const unsigned RadarIntervalMs = 100;
+
+// two triangles, 0 1 2 and 1 3 2
+struct Quad
+{
+    double vertexes[4][4];
+    unsigned colors[4];
+};
+
+// the quads of an element are rebuilt only when its inputs change
+struct Element
+{
+    int first;
+    double inputs[MaxInputs];
+    bool is_built;
+};
+
+void set_rect(  Quad* quad,
+                pair< double, double > p0,
                 pair< double, double > p1,
                 pair< double, double > p2,
                 pair< double, double > p3,
-                unsigned c0,
-                unsigned c1,
-                unsigned c2,
-                unsigned c3,
-                GameLib::Framework f,
+                unsigned color,
                 double z = 0.0,
                 double w = 1.0)
 {
-    double q0[4];
-    double q1[4];
-    double q2[4];
-    double q3[4];
-
-    q0[0] = p0.first;
-    q0[1] = p0.second;
-    q0[2] = z;
-    q0[3] = w;
-    q1[0] = p1.first;
-    q1[1] = p1.second;
-    q1[2] = z;
-    q1[3] = w;
-    q2[0] = p2.first;
-    q2[1] = p2.second;
-    q2[2] = z;
-    q2[3] = w;
-    q3[0] = p3.first;
-    q3[1] = p3.second;
-    q3[2] = z;
-    q3[3] = w;
-
-    f.drawTriangle3DH(  q0, q1, q2,
-                        0, 0, 0,
-                        c0, c1, c3);
-    f.drawTriangle3DH(  q1, q3, q2,
-                        0, 0, 0,
-                        c1, c3, c2);
+    const pair< double, double > ps[4] = { p0, p1, p2, p3 };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        quad->vertexes[i][0] = ps[i].first;
+        quad->vertexes[i][1] = ps[i].second;
+        quad->vertexes[i][2] = z;
+        quad->vertexes[i][3] = w;
+        quad->colors[i] = color;
+    }
 }
 
 void rotate(pair< double, double >* dot, double theta)
@@ -69,82 +91,46 @@ void rotate(pair< double, double >* dot, double theta)
     dot->second = cosine * x + sine * y;
 }
 
-void draw_horizontal_line(  pair< double, double > from,
+void set_horizontal_line(   Quad* quad,
+                            pair< double, double > from,
                             pair< double, double > to,
                             double thickness,
                             unsigned from_color,
                             unsigned to_color,
-                            GameLib::Framework f,
                             double z = 0.0,
                             double w = 1.0)
 {
-    double q0[4];
-    double q1[4];
-    double q2[4];
-    double q3[4];
-
-    q0[0] = from.first;
-    q0[1] = from.second + thickness;
-    q0[2] = z;
-    q0[3] = w;
-    q1[0] = to.first;
-    q1[1] = to.second + thickness;
-    q1[2] = z;
-    q1[3] = w;
-    q2[0] = from.first;
-    q2[1] = from.second - thickness;
-    q2[2] = z;
-    q2[3] = w;
-    q3[0] = to.first;
-    q3[1] = to.second - thickness;
-    q3[2] = z;
-    q3[3] = w;
-
-    f.drawTriangle3DH(  q0, q1, q2,
-                        0, 0, 0,
-                        from_color, to_color, from_color);
-    f.drawTriangle3DH(  q1, q3, q2,
-                        0, 0, 0,
-                        to_color, to_color, from_color);
+    set_rect(   quad,
+                pair< double, double >(from.first, from.second + thickness),
+                pair< double, double >(to.first, to.second + thickness),
+                pair< double, double >(from.first, from.second - thickness),
+                pair< double, double >(to.first, to.second - thickness),
+                from_color,
+                z,
+                w);
+    quad->colors[1] = to_color;
+    quad->colors[3] = to_color;
 }
 
-void draw_vertical_line(    pair< double, double > from,
-                            pair< double, double > to,
-                            double thickness,
-                            unsigned from_color,
-                            unsigned to_color,
-                            GameLib::Framework f,
-                            double z = 0.0,
-                            double w = 1.0)
+void set_vertical_line( Quad* quad,
+                        pair< double, double > from,
+                        pair< double, double > to,
+                        double thickness,
+                        unsigned from_color,
+                        unsigned to_color,
+                        double z = 0.0,
+                        double w = 1.0)
 {
-    double q0[4];
-    double q1[4];
-    double q2[4];
-    double q3[4];
-
-    q0[0] = from.first - thickness;
-    q0[1] = from.second;
-    q0[2] = z;
-    q0[3] = w;
-    q1[0] = from.first + thickness;
-    q1[1] = from.second;
-    q1[2] = z;
-    q1[3] = w;
-    q2[0] = to.first - thickness;
-    q2[1] = to.second;
-    q2[2] = z;
-    q2[3] = w;
-    q3[0] = to.first + thickness;
-    q3[1] = to.second;
-    q3[2] = z;
-    q3[3] = w;
-
-    f.drawTriangle3DH(  q0, q1, q2,
-                        0, 0, 0,
-                        from_color, from_color, to_color);
-    f.drawTriangle3DH(  q1, q3, q2,
-                        0, 0, 0,
-                        from_color, to_color, to_color);
+    set_rect(   quad,
+                pair< double, double >(from.first - thickness, from.second),
+                pair< double, double >(from.first + thickness, from.second),
+                pair< double, double >(to.first - thickness, to.second),
+                pair< double, double >(to.first + thickness, to.second),
+                from_color,
+                z,
+                w);
+    quad->colors[2] = to_color;
+    quad->colors[3] = to_color;
 }
 
 unsigned calc_gradation_color(unsigned from, unsigned to, double rate)
@@ -182,9 +168,216 @@ unsigned calc_gradation_color_non_linear(   unsigned from,
     return calc_gradation_color(from, to, std::pow(rate, 2.0));
 }
 
-void draw_time_bar()
+class Impl
+{
+private:
+    std::vector< Quad > quads_; // of the elements, then of the blips
+    int element_quad_count_;
+    Element elements_[ElementSize];
+    int rebuilt_count_; // elements, in the last draw
+    Radar radar_;
+    unsigned radar_colors_[RadarColorSteps];
+
+public:
+    Impl();
+    ~Impl();
+    void add_contact(const Vector3& position);
+    void draw(const Robo& player, const Robo& opponent);
+    void print(std::ostringstream* oss) const;
+
+private:
+    bool is_dirty(  ElementId id,
+                    double a,
+                    double b = 0.0,
+                    double c = 0.0,
+                    double d = 0.0);
+    Quad* quad(ElementId id, int i = 0);
+    void build_radar_frame();
+    void submit() const;
+    void update_energy_bar(const Robo& player);
+    void update_hp_bar(const Robo& player);
+    void update_lock_on_sight(const Robo& player, const Robo& opponent);
+    void update_opponent_hp_bar(const Robo& player, const Robo& opponent);
+    void update_radar_map(const Robo& player);
+    void update_time_bar();
+};
+
+Impl::Impl()
+:   quads_(), element_quad_count_(0), rebuilt_count_(0),
+    radar_(RadarRange, RadarScaleLength, RadarIntervalMs)
+{
+    for (int i = 0; i < ElementSize; ++i)
+    {
+        elements_[i].first = element_quad_count_;
+        elements_[i].is_built = false;
+        element_quad_count_ = element_quad_count_ + QuadCounts[i];
+    }
+
+    quads_.resize(element_quad_count_);
+    build_radar_frame();
+
+    for (int i = 0; i < RadarColorSteps; ++i)
+    {
+        radar_colors_[i]
+        = calc_gradation_color( RadarColorFrom,
+                                RadarColorTo,
+                                static_cast< double >(i)
+                                / (RadarColorSteps - 1));
+    }
+}
+
+Impl::~Impl() {}
+
+void Impl::add_contact(const Vector3& position) { radar_.add(position); }
+
+// the radar frame and the player on it never change
+void Impl::build_radar_frame()
+{
+    const pair< double, double >& center = RadarCenter;
+    const double half_size = RadarHalfSize;
+
+    const pair< double, double > top_left(  center.first - half_size,
+                                            center.second + half_size);
+    const pair< double, double > top_right( center.first + half_size,
+                                            center.second + half_size);
+    const pair< double, double > bottom_left(   center.first - half_size,
+                                                center.second - half_size);
+    const pair< double, double > bottom_right(  center.first + half_size,
+                                                center.second - half_size);
+
+    const unsigned line_color = 0xea1a4404;
+
+    set_horizontal_line(    quad(ElementRadarFrame, 0),
+                            top_left,
+                            top_right,
+                            0.005,
+                            line_color,
+                            line_color);
+    set_horizontal_line(    quad(ElementRadarFrame, 1),
+                            bottom_left,
+                            bottom_right,
+                            0.005,
+                            line_color,
+                            line_color);
+    set_vertical_line(  quad(ElementRadarFrame, 2),
+                        top_left,
+                        bottom_left,
+                        0.005,
+                        line_color,
+                        line_color);
+    set_vertical_line(  quad(ElementRadarFrame, 3),
+                        top_right,
+                        bottom_right,
+                        0.005,
+                        line_color,
+                        line_color);
+    elements_[ElementRadarFrame].is_built = true;
+
+    const unsigned player_color = calc_gradation_color( RadarColorFrom,
+                                                        RadarColorTo,
+                                                        0.5);
+    const double player_half_size = 0.01;
+    const double player_left = center.first - player_half_size;
+    const double player_right = center.first + player_half_size;
+    const double player_top = center.second + player_half_size;
+    const double player_bottom = center.second - player_half_size;
+    const pair< double, double > player_top_left(player_left, player_top);
+    const pair< double, double > player_top_right(player_right, player_top);
+    const pair< double, double > player_bottom_left(    player_left,
+                                                        player_bottom);
+    const pair< double, double > player_bottom_right(   player_right,
+                                                        player_bottom);
+    set_rect(   quad(ElementRadarPlayer),
+                player_top_left,
+                player_top_right,
+                player_bottom_left,
+                player_bottom_right,
+                player_color);
+    elements_[ElementRadarPlayer].is_built = true;
+}
+
+void Impl::draw(const Robo& player, const Robo& opponent)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
+    rebuilt_count_ = 0;
+
+    update_time_bar();
+    update_energy_bar(player);
+    update_hp_bar(player);
+    update_opponent_hp_bar(player, opponent);
+    update_lock_on_sight(player, opponent);
+    update_radar_map(player);
+
+    submit();
+}
+
+bool Impl::is_dirty(ElementId id, double a, double b, double c, double d)
+{
+    Element& element = elements_[id];
+    const double inputs[MaxInputs] = { a, b, c, d };
+    bool is_same = element.is_built;
+
+    for (int i = 0; i < MaxInputs; ++i)
+    {
+        is_same = is_same && element.inputs[i] == inputs[i];
+        element.inputs[i] = inputs[i];
+    }
+
+    element.is_built = true;
+    rebuilt_count_ = rebuilt_count_ + (is_same ? 0 : 1);
+    return !is_same;
+}
+
+void Impl::print(std::ostringstream* oss) const
+{
+    *oss << "hud quads: ";
+    *oss << quads_.size();
+    *oss << ", rebuilt: ";
+    *oss << rebuilt_count_;
+    *oss << ", ";
+    radar_.print(oss);
+}
+
+Quad* Impl::quad(ElementId id, int i)
+{
+    assert(i >= 0 && i < QuadCounts[id]);
+    return &quads_.at(elements_[id].first + i);
+}
+
+// all in the same states, so one batch of the queue
+void Impl::submit() const
+{
+    TheDrawQueue queue = TheDrawQueue::instance();
+    queue.texture(0);
+    queue.blend_mode(TheDrawQueue::BlendLinear);
+    queue.enable_depth_test(true);
+    queue.enable_depth_write(false);
+
+    for (size_t i = 0; i < quads_.size(); ++i)
+    {
+        const Quad& quad = quads_.at(i);
+        queue.add_triangle( quad.vertexes[0],
+                            quad.vertexes[1],
+                            quad.vertexes[2],
+                            0, 0, 0,
+                            quad.colors[0],
+                            quad.colors[1],
+                            quad.colors[2]);
+        queue.add_triangle( quad.vertexes[1],
+                            quad.vertexes[3],
+                            quad.vertexes[2],
+                            0, 0, 0,
+                            quad.colors[1],
+                            quad.colors[3],
+                            quad.colors[2]);
+    }
+}
+
+void Impl::update_time_bar()
+{
+    if (!is_dirty(ElementTimeBar, TheEnvironment::RemainedBattleMs))
+    {
+        return;
+    }
 
     const double time_bar_left  = -0.8;
     const double time_bar_right = +0.8;
@@ -195,20 +388,20 @@ void draw_time_bar()
     const double current_time_bar
     = (time_bar_right - time_bar_left) * time_bar_rate + time_bar_left;
 
-    draw_rect(  pair< double, double >(time_bar_left, 0.9),
+    set_rect(   quad(ElementTimeBar),
+                pair< double, double >(time_bar_left, 0.9),
                 pair< double, double >(current_time_bar, 0.9),
                 pair< double, double >(time_bar_left, 0.8),
                 pair< double, double >(current_time_bar, 0.8),
-                0xea055c9f,
-                0xea055c9f,
-                0xea055c9f,
-                0xea055c9f,
-                f);
+                0xea055c9f);
 }
 
-void draw_energy_bar(const Robo& player)
+void Impl::update_energy_bar(const Robo& player)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
+    if (!is_dirty(ElementEnergyBar, player.energy()))
+    {
+        return;
+    }
 
     const double energy_bar_top     = +0.8;
     const double energy_bar_bottom  = -0.8;
@@ -217,278 +410,192 @@ void draw_energy_bar(const Robo& player)
     = (energy_bar_top - energy_bar_bottom) * energy_bar_rate
     + energy_bar_bottom;
 
-    draw_rect(  pair< double, double >(-0.9, energy_bar_current),
+    set_rect(   quad(ElementEnergyBar),
+                pair< double, double >(-0.9, energy_bar_current),
                 pair< double, double >(-0.8, energy_bar_current),
                 pair< double, double >(-0.9, energy_bar_bottom),
                 pair< double, double >(-0.8, energy_bar_bottom),
-                0xea2a561e,
-                0xea2a561e,
-                0xea2a561e,
-                0xea2a561e,
-                f);
+                0xea2a561e);
 }
 
-void draw_hp_bar(const Robo& player)
+void Impl::update_hp_bar(const Robo& player)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
+    if (!is_dirty(ElementHpBar, player.hp()))
+    {
+        return;
+    }
 
     const double hp_bar_left    = -0.8;
     const double hp_bar_right   = +0.8;
     const double hp = player.hp();
     const double current_hp = (hp_bar_right - hp_bar_left) * hp + hp_bar_left;
 
-    draw_rect(  pair< double, double >(hp_bar_left, -0.8),
+    set_rect(   quad(ElementHpBar),
+                pair< double, double >(hp_bar_left, -0.8),
                 pair< double, double >(current_hp, -0.8),
                 pair< double, double >(hp_bar_left, -0.9),
                 pair< double, double >(current_hp, -0.9),
-                0xeab2a770,
-                0xeab2a770,
-                0xeab2a770,
-                0xeab2a770,
-                f);
+                0xeab2a770);
 }
 
-void draw_opponent_hp_bar(const Robo& player, const Robo& opponent)
+void Impl::update_lock_on_sight(const Robo& player, const Robo& opponent)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-
-    Matrix44 transformation(player.view()->get_perspective_matrix());
-    Vector3 opponent_point(*opponent.center());
-    transformation.multiply(&opponent_point);
-
-    const double opponent_hp_bar_left   = opponent_point.x - 0.5;
-    const double opponent_hp_bar_right  = opponent_point.x + 0.5;
-    const double opponent_hp = opponent.hp();
-    const double opponent_current_hp
-    = (opponent_hp_bar_right - opponent_hp_bar_left) * opponent_hp
-    + opponent_hp_bar_left;
-
-    draw_rect(  pair< double, double >( opponent_hp_bar_left,
-                                        opponent_point.y + 1.3),
-                pair< double, double >( opponent_current_hp,
-                                        opponent_point.y + 1.3),
-                pair< double, double >( opponent_hp_bar_left,
-                                        opponent_point.y + 1.1),
-                pair< double, double >( opponent_current_hp,
-                                        opponent_point.y + 1.1),
-                0xeab2a770,
-                0xeab2a770,
-                0xeab2a770,
-                0xeab2a770,
-                f,
-                0.0,
-                opponent_point.w);
-}
-
-void draw_lock_on_sight(const Robo& player, const Robo& opponent)
-{
-    GameLib::Framework f = GameLib::Framework::instance();
-
     const double size = player.get_half_sight_size_at_depth(opponent);
     const double depth = player.get_sight_depth(opponent);
     const double lock_on_rate = player.get_lock_on_rate();
+
+    if (!is_dirty(ElementLockOnSight, size, depth, lock_on_rate))
+    {
+        return;
+    }
+
     const unsigned to_color = 0xeaf36c2e;
     const unsigned from_color
     = calc_gradation_color_non_linear(0xeac3dc0c, to_color, lock_on_rate);
 
-    draw_horizontal_line(   pair< double, double >(-size, +size),
+    set_horizontal_line(    quad(ElementLockOnSight, 0),
+                            pair< double, double >(-size, +size),
                             pair< double, double >(+size, +size),
                             0.06,
                             from_color,
                             to_color,
-                            f,
                             0.0,
                             depth);
-    draw_vertical_line( pair< double, double >(+size, +size),
+    set_vertical_line(  quad(ElementLockOnSight, 1),
+                        pair< double, double >(+size, +size),
                         pair< double, double >(+size, -size),
                         0.06,
                         from_color,
                         to_color,
-                        f,
                         0.0,
                         depth);
-    draw_horizontal_line(   pair< double, double >(-size, -size),
+    set_horizontal_line(    quad(ElementLockOnSight, 2),
+                            pair< double, double >(-size, -size),
                             pair< double, double >(+size, -size),
                             0.06,
                             from_color,
                             to_color,
-                            f,
                             0.0,
                             depth);
-    draw_vertical_line( pair< double, double >(-size, +size),
+    set_vertical_line(  quad(ElementLockOnSight, 3),
+                        pair< double, double >(-size, +size),
                         pair< double, double >(-size, -size),
                         0.06,
                         from_color,
                         to_color,
-                        f,
                         0.0,
                         depth);
 }
 
-double my_scale(double x, double max_abs)
+void Impl::update_opponent_hp_bar(const Robo& player, const Robo& opponent)
 {
-    if (x > 0.0)
-    {
-        if (x > max_abs)
-        {
-            return 1.0;
-        }
-        return x / max_abs;
-    }
-    else if (x < 0.0)
+    Matrix44 transformation(player.view()->get_perspective_matrix());
+    Vector3 opponent_point(*opponent.center());
+    transformation.multiply(&opponent_point);
+
+    if (!is_dirty(  ElementOpponentHpBar,
+                    opponent_point.x,
+                    opponent_point.y,
+                    opponent_point.w,
+                    opponent.hp()))
     {
-        if (x < -max_abs)
-        {
-            return -1.0;
-        }
-        return x / max_abs;
+        return;
     }
-    return 0.0;
+
+    const double opponent_hp_bar_left   = opponent_point.x - 0.5;
+    const double opponent_hp_bar_right  = opponent_point.x + 0.5;
+    const double opponent_hp = opponent.hp();
+    const double opponent_current_hp
+    = (opponent_hp_bar_right - opponent_hp_bar_left) * opponent_hp
+    + opponent_hp_bar_left;
+
+    set_rect(   quad(ElementOpponentHpBar),
+                pair< double, double >( opponent_hp_bar_left,
+                                        opponent_point.y + 1.3),
+                pair< double, double >( opponent_current_hp,
+                                        opponent_point.y + 1.3),
+                pair< double, double >( opponent_hp_bar_left,
+                                        opponent_point.y + 1.1),
+                pair< double, double >( opponent_current_hp,
+                                        opponent_point.y + 1.1),
+                0xeab2a770,
+                0.0,
+                opponent_point.w);
 }
 
-void draw_radar_map(const Robo& player, const Robo& opponent)
+// the blips are rebuilt at a sweep of the radar, in place of the last ones
+void Impl::update_radar_map(const Robo& player)
 {
-    Matrix44 transformation;
-    transformation.translate(-*player.center());
-    transformation.rotate_zx(player.view()->angle()->y);
+    if (!radar_.update( *player.center(),
+                        player.view()->angle()->y,
+                        TheTime::instance().delta()))
+    {
+        return;
+    }
 
-    Vector3 opponent_point(*opponent.center());
-    transformation.multiply(&opponent_point);
+    rebuilt_count_ = rebuilt_count_ + 1;
+    const int blip_count = radar_.blip_count();
+    quads_.resize(element_quad_count_ + blip_count);
 
-    const double opponent_y = opponent.center()->y;
-    const double player_y = player.center()->y;
-    const double max_abs_delta = 50.0;
-    double delta_y = opponent_y - player_y;
+    const pair< double, double >& center = RadarCenter;
+    const double blip_half_size = 0.01;
 
-    if (delta_y > max_abs_delta)
+    for (int i = 0; i < blip_count; ++i)
     {
-        delta_y = max_abs_delta;
-    }
-    else if (delta_y < -max_abs_delta)
-    {
-        delta_y = -max_abs_delta;
+        const double x = center.first + radar_.blip_x(i) * RadarHalfSize;
+        const double y = center.second + radar_.blip_y(i) * RadarHalfSize;
+        const double left = x - blip_half_size;
+        const double right = x + blip_half_size;
+        const double top = y + blip_half_size;
+        const double bottom = y - blip_half_size;
+        const double height = radar_.blip_height(i);
+        const int step
+        = static_cast< int >(height * (RadarColorSteps - 1) + 0.5);
+        set_rect(   &quads_.at(element_quad_count_ + i),
+                    pair< double, double >(left, top),
+                    pair< double, double >(right, top),
+                    pair< double, double >(left, bottom),
+                    pair< double, double >(right, bottom),
+                    radar_colors_[step]);
     }
+}
 
-    const double delta_y_rate = (delta_y + max_abs_delta)
-    / (2.0 * max_abs_delta);
-    const unsigned color_from = 0xea140cdc;
-    const unsigned color_to = 0xeadc0c0c;
-    const unsigned opponent_color = calc_gradation_color(   color_from,
-                                                            color_to,
-                                                            delta_y_rate);
-    const unsigned player_color = calc_gradation_color( color_from,
-                                                        color_to,
-                                                        0.5);
+Impl* g_impl = 0;
 
-    opponent_point.y = 0.0;
-    const double max_abs_length = 20.0;
-    opponent_point.x = my_scale(opponent_point.x, max_abs_length);
-    opponent_point.z = my_scale(opponent_point.z, max_abs_length);
+} // namespace -
 
-    const pair< double, double > center(0.825, 0.675);
-    const double half_size = 0.125;
+void TheFrontend::create()
+{
+    assert(!g_impl);
+    g_impl = new Impl();
+}
 
-    const pair< double, double > top_left(  center.first - half_size,
-                                            center.second + half_size);
-    const pair< double, double > top_right( center.first + half_size,
-                                            center.second + half_size);
-    const pair< double, double > bottom_left(   center.first - half_size,
-                                                center.second - half_size);
-    const pair< double, double > bottom_right(  center.first + half_size,
-                                                center.second - half_size);
+void TheFrontend::destroy()
+{
+    assert(g_impl);
+    delete g_impl;
+    g_impl = 0;
+}
 
-    GameLib::Framework f = GameLib::Framework::instance();
-    const unsigned line_color = 0xea1a4404;
+TheFrontend TheFrontend::instance() { return TheFrontend(); }
 
-    draw_horizontal_line(   top_left,
-                            top_right,
-                            0.005,
-                            line_color,
-                            line_color,
-                            f);
-    draw_horizontal_line(   bottom_left,
-                            bottom_right,
-                            0.005,
-                            line_color,
-                            line_color,
-                            f);
-    draw_vertical_line( top_left,
-                        bottom_left,
-                        0.005,
-                        line_color,
-                        line_color,
-                        f);
-    draw_vertical_line( top_right,
-                        bottom_right,
-                        0.005,
-                        line_color,
-                        line_color,
-                        f);
+bool TheFrontend::did_create() { return !!g_impl; }
 
-    const double player_half_size = 0.01;
-    const double player_left = center.first - player_half_size;
-    const double player_right = center.first + player_half_size;
-    const double player_top = center.second + player_half_size;
-    const double player_bottom = center.second - player_half_size;
-    const pair< double, double > player_top_left(player_left, player_top);
-    const pair< double, double > player_top_right(player_right, player_top);
-    const pair< double, double > player_bottom_left(    player_left,
-                                                        player_bottom);
-    const pair< double, double > player_bottom_right(   player_right,
-                                                        player_bottom);
-    draw_rect(  player_top_left,
-                player_top_right,
-                player_bottom_left,
-                player_bottom_right,
-                player_color,
-                player_color,
-                player_color,
-                player_color,
-                f);
-
-    const double opponent_half_size = 0.01;
-    opponent_point.scale(half_size);
-    const pair< double, double > opponent_center(   center.first
-                                                    + opponent_point.x,
-                                                    center.second
-                                                    + -opponent_point.z);
-    const double opponent_left = opponent_center.first - opponent_half_size;
-    const double opponent_right = opponent_center.first + opponent_half_size;
-    const double opponent_top = opponent_center.second + opponent_half_size;
-    const double opponent_bottom = opponent_center.second - opponent_half_size;
-    const pair< double, double > opponent_top_left( opponent_left,
-                                                    opponent_top);
-    const pair< double, double > opponent_top_right(    opponent_right,
-                                                        opponent_top);
-    const pair< double, double > opponent_bottom_left(  opponent_left,
-                                                        opponent_bottom);
-    const pair< double, double > opponent_bottom_right( opponent_right,
-                                                        opponent_bottom);
-    draw_rect(  opponent_top_left,
-                opponent_top_right,
-                opponent_bottom_left,
-                opponent_bottom_right,
-                opponent_color,
-                opponent_color,
-                opponent_color,
-                opponent_color,
-                f);
+TheFrontend::TheFrontend() {}
+
+TheFrontend::~TheFrontend() {}
+
+void TheFrontend::add_contact(const Vector3& position) const
+{
+    g_impl->add_contact(position);
 }
 
-} // namespace -
+void TheFrontend::draw(const Robo& player, const Robo& opponent) const
+{
+    g_impl->draw(player, opponent);
+}
 
-void TheFrontend::draw(const Robo& player, const Robo& opponent)
+void TheFrontend::print(std::ostringstream* oss) const
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.setTexture(0);
-    f.setBlendMode(GameLib::Framework::BLEND_LINEAR);
-    f.enableDepthTest(true);
-    f.enableDepthWrite(false);
-
-    draw_time_bar();
-    draw_energy_bar(player);
-    draw_hp_bar(player);
-    draw_opponent_hp_bar(player, opponent);
-    draw_lock_on_sight(player, opponent);
-    draw_radar_map(player, opponent);
+    g_impl->print(oss);
 }
@@ -1,13 +1,34 @@
 #ifndef ROBOFTHEFRONTEND_H_
 #define ROBOFTHEFRONTEND_H_
+#include <sstream>
+
+namespace GraphicsDatabase { class Vector3; }
 
 class Robo;
 class View;
 
+using GraphicsDatabase::Vector3;
+
+// The HUD, kept as quads from frame to frame.  An element rebuilds its
+// quads only when the values it shows change, the radar frame never, the
+// blips of the radar at its sweeps.  All of them go to the draw queue in
+// the same states, as one batch.
 class TheFrontend
 {
 public:
-    static void draw(const Robo& player, const Robo& opponent);
+    static void create();
+    static void destroy();
+    static TheFrontend instance();
+    static bool did_create();
+
+private:
+    TheFrontend();
+
+public:
+    ~TheFrontend();
+    void add_contact(const Vector3& position) const; // for the radar map
+    void draw(const Robo& player, const Robo& opponent) const;
+    void print(std::ostringstream* oss) const;
 };
 
 #endif
@@ -0,0 +1,423 @@
+#include "TheGame.h"
+#include <chrono>
+#include "GameLib/Framework.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "Ai/TheArmoury.h"
+#include "Frustum.h"
+#include "Pad.h"
+#include "Platform.h"
+#include "Robo.h"
+#include "TheCollision.h"
+#include "TheDatabase.h"
+#include "TheDebugOutput.h"
+#include "TheDrawQueue.h"
+#include "TheEnvironment.h"
+#include "TheFrontend.h"
+#include "TheHitQueue.h"
+#include "TheHorizon.h"
+#include "TheParticles.h"
+#include "ThePoses.h"
+#include "TheProfiler.h"
+#include "TheTime.h"
+#include "View.h"
+#include "Wall.h"
+#include "WeaponProfile.h"
+
+using namespace std;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const double NearClip   = 0.5;
+const double FarClip    = 1000.0;
+const char* const TraceFilename = "trace.json";
+const int MaxBulletsPerRobo = 1000;
+
+Robo* g_robo = 0;
+Robo* g_opponent = 0;
+Wall* g_wall = 0;
+std::chrono::steady_clock::time_point g_frame_begin;
+bool g_has_frame_begun = false;
+bool g_does_print_debug = ROBOF_DEBUG_LINES; // the objects under the stats
+
+void make_sure_globals_are()
+{
+    if (!TheTime::did_create())
+    {
+        TheTime::create();
+    }
+
+    if (!TheHorizon::did_create())
+    {
+        TheHorizon::create();
+    }
+
+    if (!TheDatabase::did_create())
+    {
+        TheDatabase::create();
+    }
+
+    if (!Ai::TheArmoury::did_create())
+    {
+        Ai::TheArmoury::create(MaxBulletsPerRobo);
+    }
+
+    if (!TheHitQueue::did_create())
+    {
+        TheHitQueue::create();
+    }
+
+    if (!TheParticles::did_create())
+    {
+        TheParticles::create();
+    }
+
+    if (!TheDrawQueue::did_create())
+    {
+        TheDrawQueue::create();
+    }
+
+    if (!ThePoses::did_create())
+    {
+        ThePoses::create();
+    }
+
+    if (!TheFrontend::did_create())
+    {
+        TheFrontend::create();
+    }
+
+    if (!g_robo)
+    {
+        g_robo = new Robo("myrobo");
+        g_robo->warp(Vector3(0.0, 10.0, -1.0));
+        g_robo->set_model_angle_zx(180.0);
+        g_robo->view(   Platform::width(),
+                        Platform::height(),
+                        NearClip,
+                        FarClip);
+    }
+
+    if (!g_opponent)
+    {
+        g_opponent = new Robo("opponent");
+        g_opponent->warp(Vector3(0.0, 10.0, -20));
+        g_opponent->view(   Platform::width(),
+                            Platform::height(),
+                            NearClip,
+                            FarClip);
+    }
+
+    if (!g_wall)
+    {
+        g_wall = new Wall("wall");
+        g_wall->warp(Vector3(0.0, 1.2, -15.0));
+    }
+}
+
+void clear_globals()
+{
+    TheTime::destroy();
+    TheHorizon::destroy();
+    Ai::TheArmoury::destroy();
+    TheHitQueue::destroy();
+    TheParticles::destroy();
+    TheDrawQueue::destroy();
+    ThePoses::destroy();
+    TheFrontend::destroy();
+    TheDatabase::destroy();
+    SAFE_DELETE(g_robo);
+    SAFE_DELETE(g_opponent);
+    SAFE_DELETE(g_wall);
+    TheEnvironment::RemainedBattleMs = TheEnvironment::MaxBattleMs;
+}
+
+// the wall time since the last frame began, as the clock of the platform
+// may go by fixed steps
+double get_frame_ms()
+{
+    using namespace std::chrono;
+    const steady_clock::time_point now = steady_clock::now();
+    const duration< double, std::milli > elapsed = now - g_frame_begin;
+    const double ms = g_has_frame_begun ? elapsed.count() : 0.0;
+    g_frame_begin = now;
+    g_has_frame_begun = true;
+    return ms;
+}
+
+} // namespace -
+
+void TheGame::update()
+{
+    {
+        TheProfiler::Zone frame("frame");
+        make_sure_globals_are();
+
+        TheTime::instance().tick();
+        TheDebugOutput::clear();
+
+        TheDebugOutput::pin(TheDebugOutput::StatFrameMs, get_frame_ms());
+
+        Pad pad(0);
+        Vector3 move_direction;
+
+        {
+            TheProfiler::Zone zone("input");
+
+            if (pad.isTriggered(Pad::Option))
+            {
+                TheTime::instance().rate(TheTime::instance().rate() + 0.1);
+            }
+            else if (pad.isTriggered(Pad::Option2))
+            {
+                TheTime::instance().rate(TheTime::instance().rate() - 0.1);
+            }
+
+            if (pad.isOn(Pad::LeftStickUp))
+            {
+                move_direction.add(Vector3(0.0, 0.0, +1.0));
+            }
+            if (pad.isOn(Pad::LeftTrigger))
+            {
+                move_direction.add(Vector3(+1.0, 0.0, 0.0));
+            }
+            if (pad.isOn(Pad::RightTrigger))
+            {
+                move_direction.add(Vector3(-1.0, 0.0, 0.0));
+            }
+            if (pad.isOn(Pad::LeftStickDown))
+            {
+                move_direction.add(Vector3(0.0, 0.0, -1.0));
+            }
+
+            if (move_direction.length() > 0)
+            {
+                move_direction.normalize(1.0);
+                g_robo->run(move_direction);
+            }
+
+            if (pad.isTriggered(Pad::Weapon))
+            {
+                g_robo->switch_weapon();
+            }
+
+            if (pad.isOn(Pad::A))
+            {
+                g_robo->fire_bullet(g_opponent);
+            }
+
+            if (pad.isOn(Pad::B))
+            {
+                g_robo->boost(move_direction);
+            }
+            else
+            {
+                g_robo->absorb_energy();
+            }
+
+            if (pad.isOn(Pad::LeftStickRight))
+            {
+                g_robo->rotate_zx(-1);
+            }
+
+            if (pad.isOn(Pad::LeftStickLeft))
+            {
+                g_robo->rotate_zx(1);
+            }
+
+            if (pad.isTriggered(Pad::Option))
+            {
+            }
+            else if (pad.isTriggered(Pad::Option2))
+            {
+            }
+
+            Vector3 angle_diff;
+
+            if (pad.isOn(Pad::RightStickLeft))
+            {
+                angle_diff.add(Vector3(0.0, -1.0, 0.0));
+            }
+            if (pad.isOn(Pad::RightStickDown))
+            {
+                angle_diff.add(Vector3(-1.0, 0.0, 0.0));
+            }
+            if (pad.isOn(Pad::RightStickUp))
+            {
+                angle_diff.add(Vector3(+1.0, 0.0, 0.0));
+            }
+            if (pad.isOn(Pad::RightStickRight))
+            {
+                angle_diff.add(Vector3(0.0, +1.0, 0.0));
+            }
+
+            if (angle_diff.length() > 0)
+            {
+                g_robo->view()->rotate(angle_diff);
+            }
+        }
+
+        {
+            TheProfiler::Zone zone("armoury update");
+            Ai::TheArmoury::instance().update();
+        }
+
+        {
+            TheProfiler::Zone zone("robo update");
+            g_robo->update(*g_opponent);
+            g_opponent->update(*g_robo);
+            g_opponent->defend();
+        }
+
+        {
+            TheProfiler::Zone slide("slide");
+            {
+                TheProfiler::Zone zone("slide robo");
+                TheCollision::slide_next_move_if_collision_will_occur(g_robo);
+            }
+            {
+                TheProfiler::Zone zone("slide robo opponent");
+                TheCollision::slide_next_move_if_collision_will_occur(
+                    g_robo,
+                    g_opponent);
+            }
+            // TheCollision::slide_next_move_if_collision_will_occur(
+            //     g_robo,
+            //     g_wall);
+            {
+                TheProfiler::Zone zone("slide opponent");
+                TheCollision::slide_next_move_if_collision_will_occur(
+                    g_opponent);
+            }
+            {
+                TheProfiler::Zone zone("slide opponent robo");
+                TheCollision::slide_next_move_if_collision_will_occur(
+                    g_opponent,
+                    g_robo);
+            }
+            // TheCollision::slide_next_move_if_collision_will_occur(
+            //     g_opponent,
+            //     g_wall);
+        }
+
+        {
+            TheProfiler::Zone zone("commit");
+            g_robo->commit_next_position();
+            g_opponent->commit_next_position();
+        }
+
+        {
+            TheProfiler::Zone zone("poses update");
+            ThePoses::instance().update(TheTime::instance().delta());
+        }
+
+        {
+            TheProfiler::Zone zone("armoury collision");
+            Ai::TheArmoury::instance().make_collision(TheHorizon::instance());
+            Ai::TheArmoury::instance().make_collision(g_opponent);
+            Ai::TheArmoury::instance().make_collision(g_robo);
+            Ai::TheArmoury::instance().intercept();
+        }
+
+        const Ai::TheArmoury armoury = Ai::TheArmoury::instance();
+        TheDebugOutput::pin(    TheDebugOutput::StatBulletsLive,
+                                armoury.live_count());
+        TheDebugOutput::pin(    TheDebugOutput::StatCollisionTests,
+                                armoury.collision_test_count());
+
+        {
+            TheProfiler::Zone zone("particles update");
+            TheHitQueue::instance().apply();
+            TheParticles::instance().emit(*TheHitQueue::instance().applied());
+            TheParticles::instance().update();
+        }
+
+        if (g_does_print_debug)
+        {
+            TheDebugOutput::print(Ai::TheArmoury::instance());
+            TheDebugOutput::print(g_robo->weapon()->id.c_str());
+        }
+
+        // TheDebugOutput::print(*g_robo);
+        // TheDebugOutput::print(*g_robo->view());
+
+        TheEnvironment::tick();
+
+        {
+            TheProfiler::Zone draw("draw");
+            {
+                TheProfiler::Zone zone("draw robos");
+                g_robo->draw(*g_robo->view());
+                g_opponent->draw(*g_robo->view());
+            }
+            {
+                TheProfiler::Zone zone("draw horizon");
+                TheHorizon::instance().draw(*g_robo->view());
+            }
+            // g_wall->draw(*g_robo->view());
+            {
+                TheProfiler::Zone zone("draw armoury");
+                Ai::TheArmoury::instance().draw(*g_robo->view());
+            }
+            {
+                TheProfiler::Zone zone("draw particles");
+                TheParticles::instance().draw(*g_robo->view());
+            }
+            {
+                TheProfiler::Zone zone("hud");
+                TheFrontend::instance().add_contact(*g_opponent->center());
+                TheFrontend::instance().draw(*g_robo, *g_opponent);
+            }
+            {
+                TheProfiler::Zone zone("draw queue flush");
+                TheDrawQueue::instance().flush();
+            }
+        }
+
+        if (g_does_print_debug)
+        {
+            TheDebugOutput::print(*g_robo->view()->frustum());
+            TheDebugOutput::print(TheDrawQueue::instance());
+            TheDebugOutput::print(ThePoses::instance());
+            TheDebugOutput::print(TheFrontend::instance());
+            // TheDebugOutput::print(ThePoses::instance().clip(0));
+        }
+
+        TheProfiler::print(); // of the last frame
+
+        if (pad.isTriggered(Pad::Debug))
+        {
+            g_does_print_debug = !g_does_print_debug;
+        }
+
+        if (pad.isTriggered(Pad::Profile))
+        {
+            TheProfiler::save(TraceFilename);
+        }
+
+        if (pad.isOn(Pad::Reset))
+        {
+            clear_globals();
+        }
+
+        if (pad.isOn(Pad::Terminate))
+        {
+            Platform::request_end();
+        }
+
+        if (Platform::is_end_requested())
+        {
+            clear_globals();
+        }
+
+        TheDebugOutput::flush();
+
+        {
+            TheProfiler::Zone zone("end frame");
+            Platform::end_frame();
+        }
+    } // the frame zone ends before it is summed up
+
+    TheProfiler::end_frame();
+}
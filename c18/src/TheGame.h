@@ -0,0 +1,11 @@
+#ifndef ROBOFTHEGAME_H_
+#define ROBOFTHEGAME_H_
+
+// A frame of the game, the same in every shell which runs it.
+class TheGame
+{
+public:
+    static void update();
+};
+
+#endif
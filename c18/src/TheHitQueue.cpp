@@ -0,0 +1,164 @@
+#include "TheHitQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "Ai/TheArmoury.h"
+#include "Bullet.h"
+#include "Hit.h"
+#include "Robo.h"
+
+namespace
+{
+
+const size_t ReservedHits = 256;
+
+} // namespace -
+
+namespace
+{
+
+class Impl
+{
+private:
+    std::vector< Hit > buffers_[TheHitQueue::MaxThreads];
+    std::vector< Hit > merged_;
+    std::vector< Hit > applied_;
+    size_t dropped_;
+
+public:
+    Impl();
+    ~Impl();
+    const std::vector< Hit >* applied() const;
+    void apply();
+    std::vector< Hit >* buffer(int thread_index);
+    size_t dropped() const;
+};
+
+Impl::Impl()
+:   merged_(), applied_(), dropped_(0)
+{
+    for (int i = 0; i < TheHitQueue::MaxThreads; ++i)
+    {
+        buffers_[i].reserve(ReservedHits);
+    }
+
+    merged_.reserve(ReservedHits);
+    applied_.reserve(ReservedHits);
+}
+
+Impl::~Impl() {}
+
+const std::vector< Hit >* Impl::applied() const { return &applied_; }
+
+namespace
+{
+
+// by the handles, so the order does not depend on the slots of the bullets
+bool is_earlier(const Hit& a, const Hit& b)
+{
+    if (a.bullet_handle != b.bullet_handle)
+    {
+        return a.bullet_handle < b.bullet_handle;
+    }
+
+    if (a.t != b.t)
+    {
+        return a.t < b.t;
+    }
+
+    return a.sequence < b.sequence;
+}
+
+} // namespace -
+
+// The only place which writes the results of the collision passes.  The
+// hits are numbered in the order they were recorded, so the ties at the
+// same t are broken the same way every run.
+void Impl::apply()
+{
+    merged_.clear();
+    applied_.clear();
+
+    for (int i = 0; i < TheHitQueue::MaxThreads; ++i)
+    {
+        merged_.insert(merged_.end(), buffers_[i].begin(), buffers_[i].end());
+        buffers_[i].clear();
+    }
+
+    for (size_t i = 0; i < merged_.size(); ++i)
+    {
+        merged_.at(i).sequence = static_cast< unsigned >(i);
+    }
+
+    std::sort(merged_.begin(), merged_.end(), is_earlier);
+
+    const Ai::TheArmoury armoury = Ai::TheArmoury::instance();
+
+    for (size_t i = 0; i < merged_.size(); ++i)
+    {
+        const Hit& hit = merged_.at(i);
+
+        // a bullet burns only at its earliest hit
+        if (i > 0 && merged_.at(i - 1).bullet_handle == hit.bullet_handle)
+        {
+            continue;
+        }
+
+        if (hit.target)
+        {
+            hit.target->was_shot(armoury.find(hit.bullet_handle)->damage());
+        }
+
+        armoury.burn_at(hit.bullet_handle, hit.point);
+        applied_.push_back(hit);
+    }
+
+    dropped_ = merged_.size() - applied_.size();
+}
+
+std::vector< Hit >* Impl::buffer(int thread_index)
+{
+    assert(thread_index >= 0 && thread_index < TheHitQueue::MaxThreads);
+    return &buffers_[thread_index];
+}
+
+size_t Impl::dropped() const { return dropped_; }
+
+Impl* g_impl = 0;
+
+} // namespace -
+
+void TheHitQueue::create()
+{
+    assert(!g_impl);
+    g_impl = new Impl();
+}
+
+void TheHitQueue::destroy()
+{
+    assert(g_impl);
+    delete g_impl;
+    g_impl = 0;
+}
+
+TheHitQueue TheHitQueue::instance() { return TheHitQueue(); }
+
+bool TheHitQueue::did_create() { return !!g_impl; }
+
+TheHitQueue::TheHitQueue() {}
+
+TheHitQueue::~TheHitQueue() {}
+
+const std::vector< Hit >* TheHitQueue::applied() const
+{
+    return g_impl->applied();
+}
+
+void TheHitQueue::apply() const { g_impl->apply(); }
+
+std::vector< Hit >* TheHitQueue::buffer(int thread_index) const
+{
+    return g_impl->buffer(thread_index);
+}
+
+size_t TheHitQueue::dropped() const { return g_impl->dropped(); }
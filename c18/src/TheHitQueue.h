@@ -0,0 +1,30 @@
+#ifndef ROBOFTHEHITQUEUE_H_
+#define ROBOFTHEHITQUEUE_H_
+#include <cstddef>
+#include <vector>
+
+class Hit;
+
+class TheHitQueue
+{
+public:
+    static const int MaxThreads = 1; // all passes run on the main thread
+
+public:
+    static void create();
+    static void destroy();
+    static TheHitQueue instance();
+    static bool did_create();
+
+private:
+    TheHitQueue();
+
+public:
+    ~TheHitQueue();
+    const std::vector< Hit >* applied() const;
+    void apply() const;
+    std::vector< Hit >* buffer(int thread_index) const;
+    size_t dropped() const;
+};
+
+#endif
@@ -1,10 +1,15 @@
 #include "TheHorizon.h"
+#include <cassert>
 #include <vector>
 #include "GameLib/Framework.h"
 #include "GraphicsDatabase/Matrix44.h"
 #include "GraphicsDatabase/Vector3.h"
+#include "BatchTransform.h"
 #include "Cuboid.h"
+#include "Image.h"
+#include "Platform.h"
 #include "Sphere.h"
+#include "TheDrawQueue.h"
 #include "Triangle.h"
 #include "View.h"
 
@@ -14,9 +19,10 @@ using GraphicsDatabase::Vector3;
 namespace
 {
 
+const char* const TextureFilename = "data/image/stage.tga";
 const double TextureHeightInTheView = 2.0;
 const double TextureWidthInTheView  = TextureHeightInTheView;
-const int MaxDepth          = -10;
+const int DefaultDepth      = 10; // rows of the tiles
 const unsigned GrandColor   = 0xffeaeaea;
 const unsigned SkyColor     = 0xff101010;
 
@@ -25,29 +31,53 @@ const unsigned SkyColor     = 0xff101010;
 namespace
 {
 
+// The tiles of the ground share the corners, so the corners are a grid of
+// the rows from -depth to the near clip, the columns from -depth to +depth.
+// The grid and its colors are built once; a frame transforms the grid
+// only when the view has changed.
 class Impl
 {
 private:
     GameLib::Texture* texture_;
+    Image image_;
     double height_;
+    int depth_;
+    int near_row_;
     Vector3 uv_vertexes_[4];
     Vector3 vertexes_[4];
+    std::vector< double > grid_xs_;
+    std::vector< double > grid_ys_;
+    std::vector< double > grid_zs_;
+    std::vector< unsigned > grid_colors_;
+    std::vector< Vector3 > transformed_;
+    const View* transformed_view_;
+    unsigned transformed_revision_;
     std::vector< Triangle > triangles_;
 
 public:
     Impl();
     ~Impl();
+    int depth() const;
+    void depth(int rows);
     void draw(const View& view);
     const std::vector< Triangle >* triangles() const;
+
+private:
+    void build_grid(int near_row);
+    int columns() const;
+    int get_index(int row, int column) const;
 };
 
 Impl::Impl()
-:   texture_(0), height_(0.0),
+:   texture_(0), image_(), height_(0.0),
+    depth_(DefaultDepth), near_row_(0),
     uv_vertexes_(), vertexes_(),
+    grid_xs_(), grid_ys_(), grid_zs_(), grid_colors_(),
+    transformed_(), transformed_view_(0), transformed_revision_(0),
     triangles_()
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.createTexture(&texture_, "data/image/stage.tga");
+    Platform::create_texture(TextureFilename, &texture_);
+    Image::load(TextureFilename, &image_);
 
     triangles_.reserve(2);
     triangles_.push_back(Triangle(  Vector3(-1000.0, 0.0, -1000.0),
@@ -60,47 +90,22 @@ Impl::Impl()
 
 Impl::~Impl()
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.destroyTexture(&texture_);
+    Platform::destroy_texture(&texture_);
     triangles_.clear();
 }
 
-namespace
-{
-
-// z
-// | vertex0 vertex1
-// | vertex2 vertex3
-// |-------x-------->
-// |
-// v
+int Impl::depth() const { return depth_; }
 
-void set_4vertexex( Vector3* vertexes,
-                    double z_depth,
-                    double x_move,
-                    double height)
+void Impl::depth(int rows)
 {
-    vertexes[0].x = (z_depth + x_move) * TextureWidthInTheView;
-    vertexes[0].y = -height;
-    vertexes[0].z = z_depth * TextureHeightInTheView;
-    vertexes[0].w = 1.0;
-
-    vertexes[1].x = vertexes[0].x + TextureWidthInTheView;
-    vertexes[1].y = -height;
-    vertexes[1].z = vertexes[0].z;
-    vertexes[1].w = 1.0;
-
-    vertexes[2].x = vertexes[0].x;
-    vertexes[2].y = -height;
-    vertexes[2].z = vertexes[0].z + TextureHeightInTheView;
-    vertexes[2].w = 1.0;
-
-    vertexes[3].x = vertexes[1].x;
-    vertexes[3].y = -height;
-    vertexes[3].z = vertexes[2].z;
-    vertexes[3].w = 1.0;
+    assert(rows > 0);
+    depth_ = rows;
+    grid_xs_.clear(); // built again on the next draw
 }
 
+namespace
+{
+
 void set_uv_vertexes(Vector3* vertexes)
 {
     vertexes[0].x = 0.0;
@@ -113,9 +118,10 @@ void set_uv_vertexes(Vector3* vertexes)
     vertexes[3].y = 1.0;
 }
 
-unsigned get_color(int depth)
+// from the grand color at the depth 0 to the sky color at the max depth
+unsigned get_color(int depth, int max_depth)
 {
-    const int fixed_max_depth = MaxDepth - 1;
+    const int fixed_max_depth = max_depth - 1;
     const int alpha      = (GrandColor & 0xff000000) >> 24;
     const int from_red   = (GrandColor & 0x00ff0000) >> 16;
     const int from_green = (GrandColor & 0x0000ff00) >> 8;
@@ -132,7 +138,8 @@ unsigned get_color(int depth)
 
 void set_4vertexex_to_the_horizon(  Vector3* vertexes,
                                     double height,
-                                    double far_clip)
+                                    double far_clip,
+                                    int max_depth)
 {
     vertexes[0].x = -far_clip;
     vertexes[0].y = -height;
@@ -146,12 +153,12 @@ void set_4vertexex_to_the_horizon(  Vector3* vertexes,
 
     vertexes[2].x = -far_clip;
     vertexes[2].y = -height;
-    vertexes[2].z = height * MaxDepth;
+    vertexes[2].z = height * max_depth;
     vertexes[2].w = 1.0;
 
     vertexes[3].x = +far_clip;
     vertexes[3].y = -height;
-    vertexes[3].z = height * MaxDepth;
+    vertexes[3].z = height * max_depth;
     vertexes[3].w = 1.0;
 }
 
@@ -166,82 +173,137 @@ void set_uv_vertexes_to_the_horizon(Vector3* vertexes)
 
 } // namespace -
 
+// z
+// | (row, column)      (row, column + 1)
+// | (row + 1, column)  (row + 1, column + 1)
+// |-------x-------->
+// |
+// v
+void Impl::build_grid(int near_row)
+{
+    near_row_ = near_row;
+    const int max_depth = -depth_;
+    const int size = (near_row_ + 1 - max_depth + 1) * columns();
+
+    grid_xs_.clear();
+    grid_ys_.clear();
+    grid_zs_.clear();
+    grid_colors_.clear();
+    grid_xs_.reserve(size);
+    grid_ys_.reserve(size);
+    grid_zs_.reserve(size);
+    grid_colors_.reserve(size);
+
+    for (int row = max_depth; row <= near_row_ + 1; ++row)
+    {
+        for (int column = max_depth; column <= -max_depth; ++column)
+        {
+            grid_xs_.push_back(column * TextureWidthInTheView);
+            grid_ys_.push_back(-height_);
+            grid_zs_.push_back(row * TextureHeightInTheView);
+            grid_colors_.push_back(get_color(row, max_depth));
+        }
+    }
+
+    transformed_.resize(size);
+    transformed_view_ = 0;
+}
+
+int Impl::columns() const { return 2 * depth_ + 1; }
+
+int Impl::get_index(int row, int column) const
+{
+    return (row + depth_) * columns() + (column + depth_);
+}
+
 void Impl::draw(const View& view)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    f.setTexture(texture_);
+    TheDrawQueue queue = TheDrawQueue::instance();
+    queue.texture(texture_, &image_);
 
     Matrix44 perspective(view.get_perspective_matrix());
+    const int near_row = -static_cast< int >(view.near_clip());
 
-    set_uv_vertexes(uv_vertexes_);
+    if (grid_xs_.empty() || near_row != near_row_)
+    {
+        build_grid(near_row);
+    }
 
-    for (int z = -static_cast< int >(view.near_clip()); z >= MaxDepth; --z)
+    if (transformed_view_ != &view
+        || transformed_revision_ != view.revision())
     {
-        unsigned near_color = get_color(z + 1);
-        unsigned far_color  = get_color(z);
+        double rows[4][4];
+        BatchTransform::get_rows(perspective, rows);
+        BatchTransform::transform(  rows,
+                                    &grid_xs_.at(0),
+                                    &grid_ys_.at(0),
+                                    &grid_zs_.at(0),
+                                    static_cast< int >(grid_xs_.size()),
+                                    &transformed_.at(0));
+        transformed_view_ = &view;
+        transformed_revision_ = view.revision();
+    }
+
+    set_uv_vertexes(uv_vertexes_);
 
-        for (int x = 0; x < -z * 2; ++x)
+    for (int z = near_row_; z >= -depth_; --z)
+    {
+        for (int x = z; x < -z; ++x)
         {
-            set_4vertexex(vertexes_, z, x, height_);
-
-// if (x == 3 && z == -2)
-// {
-//             view.draw_debug_string(&vertexes_[0 * 4].x, 1);
-//             view.draw_debug_string(&vertexes_[1 * 4].x, 2);
-//             view.draw_debug_string(&vertexes_[2 * 4].x, 3);
-// }
-
-            perspective.multiply(&vertexes_[0]);
-            perspective.multiply(&vertexes_[1]);
-            perspective.multiply(&vertexes_[2]);
-            perspective.multiply(&vertexes_[3]);
-
-            f.drawTriangle3DH(  &vertexes_[0].x,
-                                &vertexes_[1].x,
-                                &vertexes_[2].x,
-                                &uv_vertexes_[0].x,
-                                &uv_vertexes_[1].x,
-                                &uv_vertexes_[2].x,
-                                far_color,
-                                far_color,
-                                near_color);
-            f.drawTriangle3DH(  &vertexes_[3].x,
-                                &vertexes_[1].x,
-                                &vertexes_[2].x,
-                                &uv_vertexes_[3].x,
-                                &uv_vertexes_[1].x,
-                                &uv_vertexes_[2].x,
-                                near_color,
-                                far_color,
-                                near_color);
+            const int i0 = get_index(z, x);
+            const int i1 = get_index(z, x + 1);
+            const int i2 = get_index(z + 1, x);
+            const int i3 = get_index(z + 1, x + 1);
+
+            queue.add_triangle(  &transformed_.at(i0).x,
+                                 &transformed_.at(i1).x,
+                                 &transformed_.at(i2).x,
+                                 &uv_vertexes_[0].x,
+                                 &uv_vertexes_[1].x,
+                                 &uv_vertexes_[2].x,
+                                 grid_colors_.at(i0),
+                                 grid_colors_.at(i1),
+                                 grid_colors_.at(i2));
+            queue.add_triangle(  &transformed_.at(i3).x,
+                                 &transformed_.at(i1).x,
+                                 &transformed_.at(i2).x,
+                                 &uv_vertexes_[3].x,
+                                 &uv_vertexes_[1].x,
+                                 &uv_vertexes_[2].x,
+                                 grid_colors_.at(i3),
+                                 grid_colors_.at(i1),
+                                 grid_colors_.at(i2));
         }
     }
 
-    set_4vertexex_to_the_horizon(vertexes_, height_, view.far_clip());
+    set_4vertexex_to_the_horizon(   vertexes_,
+                                    height_,
+                                    view.far_clip(),
+                                    -depth_);
     perspective.multiply(&vertexes_[0]);
     perspective.multiply(&vertexes_[1]);
     perspective.multiply(&vertexes_[2]);
     perspective.multiply(&vertexes_[3]);
     set_uv_vertexes_to_the_horizon(uv_vertexes_);
-    unsigned near_color = get_color(MaxDepth + 1);
-    f.drawTriangle3DH(  &vertexes_[0].x,
-                        &vertexes_[1].x,
-                        &vertexes_[2].x,
-                        &uv_vertexes_[0].x,
-                        &uv_vertexes_[1].x,
-                        &uv_vertexes_[2].x,
-                        SkyColor,
-                        SkyColor,
-                        near_color);
-    f.drawTriangle3DH(  &vertexes_[3].x,
-                        &vertexes_[1].x,
-                        &vertexes_[2].x,
-                        &uv_vertexes_[3].x,
-                        &uv_vertexes_[1].x,
-                        &uv_vertexes_[2].x,
-                        near_color,
-                        SkyColor,
-                        near_color);
+    unsigned near_color = get_color(-depth_ + 1, -depth_);
+    queue.add_triangle(  &vertexes_[0].x,
+                         &vertexes_[1].x,
+                         &vertexes_[2].x,
+                         &uv_vertexes_[0].x,
+                         &uv_vertexes_[1].x,
+                         &uv_vertexes_[2].x,
+                         SkyColor,
+                         SkyColor,
+                         near_color);
+    queue.add_triangle(  &vertexes_[3].x,
+                         &vertexes_[1].x,
+                         &vertexes_[2].x,
+                         &uv_vertexes_[3].x,
+                         &uv_vertexes_[1].x,
+                         &uv_vertexes_[2].x,
+                         near_color,
+                         SkyColor,
+                         near_color);
 }
 
 const std::vector< Triangle >* Impl::triangles() const
@@ -282,6 +344,10 @@ Cuboid TheHorizon::cuboid() const
                     Vector3(100.0, 100.0, 100.0));
 }
 
+int TheHorizon::depth() const { return g_impl->depth(); }
+
+void TheHorizon::depth(int rows) const { g_impl->depth(rows); }
+
 void TheHorizon::draw(const View& view) { g_impl->draw(view); }
 
 Sphere TheHorizon::sphere() const
@@ -21,6 +21,8 @@ private:
 public:
     ~TheHorizon();
     Cuboid cuboid() const;
+    int depth() const;
+    void depth(int rows) const;
     void draw(const View& view);
     Sphere sphere() const;
     const std::vector< Triangle >* triangles() const;
@@ -0,0 +1,358 @@
+#include "TheParticles.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "GameLib/Framework.h"
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "Hit.h"
+#include "Platform.h"
+#include "TheDrawQueue.h"
+#include "TheEnvironment.h"
+#include "TheTime.h"
+#include "View.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const int SparkCapacity         = 2048;
+const int ScorchCapacity        = 256;
+const int DefaultBudget         = 32; // hits a frame, the rest are dropped
+const int SparksPerHit          = 6;
+const double SparkSpeed         = 6.0; // [m/s]
+const double SparkLifeMs        = 400.0;
+const double SparkTailS         = 0.02; // the length of a streak
+const double SparkWidth         = 0.004; // in the clip space, of x
+const unsigned SparkColor       = 0x00ffc040;
+const double ScorchLifeMs       = 8000.0;
+const double ScorchHalfSize     = 0.3; // [m]
+const double ScorchLift         = 0.01; // [m], above the ground
+const double ScorchMinNormalY   = 0.7; // a flat hit
+const unsigned ScorchColor      = 0x00101010;
+
+// a deterministic spread, the same hit gives the same sparks
+double get_spread(unsigned seed)
+{
+    seed = seed * 747796405u + 2891336453u;
+    seed = ((seed >> ((seed >> 28) + 4)) ^ seed) * 277803737u;
+    seed = (seed >> 22) ^ seed;
+    return static_cast< double >(seed & 0xffff) / 32767.5 - 1.0;
+}
+
+// The head moved across the streak in the screen.  The direction is taken
+// in the pixels, then the width in y is scaled to the same pixels as in x.
+void get_side(const Vector3& head, const Vector3& tail, Vector3* side)
+{
+    const double width = Platform::width();
+    const double height = Platform::height();
+    double across_x = 1.0;
+    double across_y = 0.0;
+
+    if (head.w > 0.0 && tail.w > 0.0)
+    {
+        const double along_x = (tail.x / tail.w - head.x / head.w) * width;
+        const double along_y = (tail.y / tail.w - head.y / head.w) * height;
+        const double length = std::sqrt(along_x * along_x + along_y * along_y);
+
+        if (length > 0.0)
+        {
+            across_x = -along_y / length;
+            across_y = along_x / length;
+        }
+    }
+
+    *side = head;
+    side->x = side->x + across_x * SparkWidth * head.w;
+    side->y = side->y + across_y * SparkWidth * width / height * head.w;
+}
+
+unsigned fade(unsigned color, double rate)
+{
+    const double alpha = 255.0 * std::max(0.0, std::min(1.0, rate));
+    return color | static_cast< unsigned >(alpha) << 24;
+}
+
+class Impl
+{
+private:
+    // the sparks, structure of arrays
+    double xs_[SparkCapacity];
+    double ys_[SparkCapacity];
+    double zs_[SparkCapacity];
+    double velocity_xs_[SparkCapacity];
+    double velocity_ys_[SparkCapacity];
+    double velocity_zs_[SparkCapacity];
+    double ages_[SparkCapacity];
+    int spark_next_;
+    // the scorches
+    Vector3 scorch_points_[ScorchCapacity];
+    double scorch_ages_[ScorchCapacity];
+    int scorch_next_;
+    int budget_;
+    unsigned emitted_;
+    std::vector< Vector3 > vertexes_;
+    std::vector< unsigned > colors_;
+
+public:
+    Impl();
+    ~Impl();
+    int budget() const;
+    void budget(int hits_per_frame);
+    void draw(const View& view);
+    void emit(const std::vector< Hit >& hits);
+    void update();
+
+private:
+    void draw_scorches(const Matrix44& perspective);
+    void draw_sparks(const Matrix44& perspective);
+};
+
+Impl::Impl()
+:   spark_next_(0),
+    scorch_next_(0),
+    budget_(DefaultBudget),
+    emitted_(0),
+    vertexes_(),
+    colors_()
+{
+    // the dead ones are older than their life
+    std::fill(xs_, xs_ + SparkCapacity, 0.0);
+    std::fill(ys_, ys_ + SparkCapacity, 0.0);
+    std::fill(zs_, zs_ + SparkCapacity, 0.0);
+    std::fill(velocity_xs_, velocity_xs_ + SparkCapacity, 0.0);
+    std::fill(velocity_ys_, velocity_ys_ + SparkCapacity, 0.0);
+    std::fill(velocity_zs_, velocity_zs_ + SparkCapacity, 0.0);
+    std::fill(ages_, ages_ + SparkCapacity, SparkLifeMs);
+    std::fill(scorch_ages_, scorch_ages_ + ScorchCapacity, ScorchLifeMs);
+    vertexes_.reserve(4 * std::max(SparkCapacity, ScorchCapacity));
+    colors_.reserve(std::max(SparkCapacity, ScorchCapacity));
+}
+
+Impl::~Impl() {}
+
+int Impl::budget() const { return budget_; }
+
+void Impl::budget(int hits_per_frame)
+{
+    assert(hits_per_frame >= 0);
+    budget_ = hits_per_frame;
+}
+
+void Impl::draw(const View& view)
+{
+    TheDrawQueue queue = TheDrawQueue::instance();
+    Matrix44 perspective(view.get_perspective_matrix());
+
+    queue.texture(0);
+    queue.enable_depth_test(true);
+    queue.enable_depth_write(false);
+    queue.blend_mode(TheDrawQueue::BlendLinear);
+    draw_scorches(perspective);
+    queue.blend_mode(TheDrawQueue::BlendAdditive);
+    draw_sparks(perspective);
+    queue.blend_mode(TheDrawQueue::BlendLinear);
+    queue.enable_depth_write(true);
+}
+
+// transforms all the corners first, then draws them in one run
+void Impl::draw_scorches(const Matrix44& perspective)
+{
+    vertexes_.clear();
+    colors_.clear();
+
+    for (int i = 0; i < ScorchCapacity; ++i)
+    {
+        if (scorch_ages_[i] >= ScorchLifeMs)
+        {
+            continue;
+        }
+
+        const Vector3& point = scorch_points_[i];
+        const double y = point.y + ScorchLift;
+        vertexes_.push_back(Vector3(point.x - ScorchHalfSize, y,
+                                    point.z - ScorchHalfSize));
+        vertexes_.push_back(Vector3(point.x + ScorchHalfSize, y,
+                                    point.z - ScorchHalfSize));
+        vertexes_.push_back(Vector3(point.x - ScorchHalfSize, y,
+                                    point.z + ScorchHalfSize));
+        vertexes_.push_back(Vector3(point.x + ScorchHalfSize, y,
+                                    point.z + ScorchHalfSize));
+        colors_.push_back(
+            fade(ScorchColor, 1.0 - scorch_ages_[i] / ScorchLifeMs));
+    }
+
+    for (size_t i = 0; i < vertexes_.size(); ++i)
+    {
+        vertexes_.at(i).w = 1.0;
+        perspective.multiply(&vertexes_.at(i));
+    }
+
+    TheDrawQueue queue = TheDrawQueue::instance();
+
+    for (size_t i = 0; i < vertexes_.size(); i = i + 4)
+    {
+        const unsigned color = colors_.at(i / 4);
+
+        queue.add_triangle(  &vertexes_.at(i).x,
+                             &vertexes_.at(i + 1).x,
+                             &vertexes_.at(i + 2).x,
+                             0, 0, 0,
+                             color, color, color);
+        queue.add_triangle(  &vertexes_.at(i + 3).x,
+                             &vertexes_.at(i + 1).x,
+                             &vertexes_.at(i + 2).x,
+                             0, 0, 0,
+                             color, color, color);
+    }
+}
+
+// a streak from the spark back along its velocity, widened in the screen
+void Impl::draw_sparks(const Matrix44& perspective)
+{
+    vertexes_.clear();
+    colors_.clear();
+
+    for (int i = 0; i < SparkCapacity; ++i)
+    {
+        if (ages_[i] >= SparkLifeMs)
+        {
+            continue;
+        }
+
+        Vector3 head(xs_[i], ys_[i], zs_[i]);
+        Vector3 tail(   xs_[i] - velocity_xs_[i] * SparkTailS,
+                        ys_[i] - velocity_ys_[i] * SparkTailS,
+                        zs_[i] - velocity_zs_[i] * SparkTailS);
+        head.w = 1.0;
+        tail.w = 1.0;
+        perspective.multiply(&head);
+        perspective.multiply(&tail);
+
+        Vector3 side;
+        get_side(head, tail, &side);
+
+        vertexes_.push_back(head);
+        vertexes_.push_back(tail);
+        vertexes_.push_back(side);
+        colors_.push_back(fade(SparkColor, 1.0 - ages_[i] / SparkLifeMs));
+    }
+
+    TheDrawQueue queue = TheDrawQueue::instance();
+
+    for (size_t i = 0; i < vertexes_.size(); i = i + 3)
+    {
+        const unsigned color = colors_.at(i / 3);
+        queue.add_triangle(  &vertexes_.at(i).x,
+                             &vertexes_.at(i + 1).x,
+                             &vertexes_.at(i + 2).x,
+                             0, 0, 0,
+                             color,
+                             SparkColor, // the tail fades out
+                             color);
+    }
+}
+
+// up to the budget of the hits, a spread of sparks each, a scorch for a hit
+// on a flat face
+void Impl::emit(const std::vector< Hit >& hits)
+{
+    const size_t size = std::min(hits.size(), static_cast< size_t >(budget_));
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const Hit& hit = hits.at(i);
+
+        for (int j = 0; j < SparksPerHit; ++j)
+        {
+            const unsigned seed = emitted_ * SparksPerHit + j;
+            const int k = spark_next_;
+            xs_[k] = hit.point.x;
+            ys_[k] = hit.point.y;
+            zs_[k] = hit.point.z;
+            velocity_xs_[k]
+            = SparkSpeed * (hit.normal.x + 0.7 * get_spread(3 * seed));
+            velocity_ys_[k]
+            = SparkSpeed * (hit.normal.y + 0.7 * get_spread(3 * seed + 1));
+            velocity_zs_[k]
+            = SparkSpeed * (hit.normal.z + 0.7 * get_spread(3 * seed + 2));
+            ages_[k] = 0.0;
+            spark_next_ = (spark_next_ + 1) % SparkCapacity;
+        }
+
+        if (!hit.target && hit.normal.y > ScorchMinNormalY)
+        {
+            scorch_points_[scorch_next_] = hit.point;
+            scorch_ages_[scorch_next_] = 0.0;
+            scorch_next_ = (scorch_next_ + 1) % ScorchCapacity;
+        }
+
+        emitted_ = emitted_ + 1;
+    }
+}
+
+// Every spark is moved, the dead ones too; no branch, so the loop is
+// vectorized by the compiler.
+void Impl::update()
+{
+    const double dt = static_cast< double >(TheTime::instance().delta());
+    const double s = dt / 1e3;
+    const double dv = TheEnvironment::gravity_acceleration() * s;
+
+    for (int i = 0; i < SparkCapacity; ++i)
+    {
+        xs_[i] = xs_[i] + velocity_xs_[i] * s;
+        ys_[i] = ys_[i] + velocity_ys_[i] * s;
+        zs_[i] = zs_[i] + velocity_zs_[i] * s;
+        velocity_ys_[i] = velocity_ys_[i] - dv;
+        ages_[i] = std::min(ages_[i] + dt, SparkLifeMs);
+    }
+
+    for (int i = 0; i < ScorchCapacity; ++i)
+    {
+        scorch_ages_[i] = std::min(scorch_ages_[i] + dt, ScorchLifeMs);
+    }
+}
+
+Impl* g_impl = 0;
+
+} // namespace -
+
+void TheParticles::create()
+{
+    ASSERT(!g_impl);
+    g_impl = new Impl();
+}
+
+void TheParticles::destroy()
+{
+    ASSERT(g_impl);
+    SAFE_DELETE(g_impl);
+}
+
+TheParticles TheParticles::instance() { return TheParticles(); }
+
+bool TheParticles::did_create() { return !!g_impl; }
+
+TheParticles::TheParticles() {}
+
+TheParticles::~TheParticles() {}
+
+int TheParticles::budget() const { return g_impl->budget(); }
+
+void TheParticles::budget(int hits_per_frame) const
+{
+    g_impl->budget(hits_per_frame);
+}
+
+void TheParticles::draw(const View& view) const { g_impl->draw(view); }
+
+void TheParticles::emit(const std::vector< Hit >& hits) const
+{
+    g_impl->emit(hits);
+}
+
+void TheParticles::update() const { g_impl->update(); }
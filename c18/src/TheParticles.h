@@ -0,0 +1,31 @@
+#ifndef ROBOFTHEPARTICLES_H_
+#define ROBOFTHEPARTICLES_H_
+#include <vector>
+
+class Hit;
+class View;
+
+// The sparks and the scorches of the bullet hits.  Both live in rings of
+// fixed capacity, a new one takes the place of the oldest, so nothing is
+// allocated and the cost of a frame is bounded by the capacity.
+class TheParticles
+{
+public:
+    static void create();
+    static void destroy();
+    static TheParticles instance();
+    static bool did_create();
+
+private:
+    TheParticles();
+
+public:
+    ~TheParticles();
+    int budget() const;
+    void budget(int hits_per_frame) const;
+    void draw(const View& view) const;
+    void emit(const std::vector< Hit >& hits) const;
+    void update() const;
+};
+
+#endif
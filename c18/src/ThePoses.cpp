@@ -0,0 +1,556 @@
+#include "ThePoses.h"
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GraphicsDatabase/Matrix44.h"
+#include "GraphicsDatabase/Vector3.h"
+#include "Animation.h"
+#include "BatchTransform.h"
+#include "DataTree.h"
+#include "Skeleton.h"
+#include "TheDrawQueue.h"
+#include "TheEnvironment.h"
+#include "View.h"
+
+using GraphicsDatabase::Matrix44;
+using GraphicsDatabase::Vector3;
+
+namespace
+{
+
+const char* const ModelsFilename = "data/models.json";
+
+const Animation::Channel PositionChannels[] = {
+    Animation::ChannelPositionX,
+    Animation::ChannelPositionY,
+    Animation::ChannelPositionZ };
+
+const Animation::Channel AngleChannels[] = {
+    Animation::ChannelAngleX,
+    Animation::ChannelAngleY,
+    Animation::ChannelAngleZ };
+
+// an entry of "models", structure of arrays
+struct Mesh
+{
+    std::string id;
+    std::vector< double > xs;
+    std::vector< double > ys;
+    std::vector< double > zs;
+    std::vector< int > indexes; // three a triangle
+};
+
+// the rows of a matrix, the last one is 0, 0, 0, 1
+struct Affine
+{
+    double m[3][4];
+};
+
+void get_local(const Vector3& position, const Vector3& angle, Affine* local)
+{
+    Matrix44 rotation;
+    rotation.rotate(angle);
+    double rows[4][4];
+    BatchTransform::get_rows(rotation, rows);
+
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int column = 0; column < 3; ++column)
+        {
+            local->m[row][column] = rows[row][column];
+        }
+    }
+
+    local->m[0][3] = position.x;
+    local->m[1][3] = position.y;
+    local->m[2][3] = position.z;
+}
+
+// c = a b
+void multiply(const Affine& a, const Affine& b, Affine* c)
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            c->m[row][column]
+            = a.m[row][0] * b.m[0][column]
+            + a.m[row][1] * b.m[1][column]
+            + a.m[row][2] * b.m[2][column];
+        }
+
+        c->m[row][3] = c->m[row][3] + a.m[row][3];
+    }
+}
+
+unsigned to_channel(double brightness)
+{
+    return static_cast< unsigned >(255.0 * std::min(1.0, brightness));
+}
+
+class Impl
+{
+private:
+    std::vector< Mesh > meshes_;
+    std::vector< Animation > animations_;
+    std::vector< Skeleton > skeletons_;
+    // the nodes of all the poses
+    std::vector< int > parents_; // -1 for a root
+    std::vector< int > poses_;
+    std::vector< int > node_meshes_; // -1 if none
+    std::vector< int > node_animations_; // -1 if none
+    std::vector< Vector3 > positions_; // at rest, or of the root
+    std::vector< Vector3 > angles_;
+    std::vector< Vector3 > scales_;
+    std::vector< Affine > locals_;
+    std::vector< Affine > worlds_;
+    std::vector< int > animated_; // the nodes of the locals to update
+    // the poses
+    std::vector< int > firsts_; // the first node
+    std::vector< int > sizes_;
+    std::vector< int > skeletons_of_poses_;
+    std::vector< double > seconds_; // of the animations
+    std::vector< int > leaders_; // the pose sampled for it, in an update
+    std::vector< int > sampled_; // the poses which lead
+    // the buffers of a draw
+    std::vector< Vector3 > world_points_;
+    std::vector< Vector3 > clip_points_;
+    int drawn_count_; // nodes, since the update
+    int sample_count_; // channels, in the update
+    int shared_count_; // nodes, in the update
+
+public:
+    Impl();
+    ~Impl();
+    int add(const std::string& tree_id);
+    const Animation& clip(int i) const;
+    int clip_count() const;
+    void draw(int pose, const View& view);
+    void print(std::ostringstream* oss) const;
+    void root(int pose, const Vector3& position, const Vector3& angle);
+    void update(unsigned delta_ms);
+
+private:
+    int find_animation(const std::string& id) const;
+    int find_mesh(const std::string& id) const;
+};
+
+Impl::Impl()
+:   meshes_(), animations_(), skeletons_(),
+    parents_(), poses_(), node_meshes_(), node_animations_(),
+    positions_(), angles_(), scales_(), locals_(), worlds_(), animated_(),
+    firsts_(), sizes_(), skeletons_of_poses_(), seconds_(), leaders_(),
+    sampled_(),
+    world_points_(), clip_points_(), drawn_count_(0), sample_count_(0),
+    shared_count_(0)
+{
+    DataTree tree;
+    DataTree::load(ModelsFilename, &tree);
+    const int models = tree.find(tree.root(), "models");
+    const int animations = tree.find(tree.root(), "animations");
+    const int trees = tree.find(tree.root(), "trees");
+    assert(models >= 0 && animations >= 0 && trees >= 0);
+
+    for (int i = 0; i < tree.size(models); ++i)
+    {
+        const int model = tree.at(models, i);
+        const int vertexes = tree.find(model, "vertexes");
+        const int indexes = tree.find(model, "indexes");
+        meshes_.push_back(Mesh());
+        Mesh& mesh = meshes_.back();
+        mesh.id = tree.string(tree.find(model, "id"));
+
+        for (int j = 0; j < tree.size(vertexes); ++j)
+        {
+            const int vertex = tree.at(vertexes, j);
+            mesh.xs.push_back(tree.number(tree.at(vertex, 0)));
+            mesh.ys.push_back(tree.number(tree.at(vertex, 1)));
+            mesh.zs.push_back(tree.number(tree.at(vertex, 2)));
+        }
+
+        for (int j = 0; j < tree.size(indexes); ++j)
+        {
+            const int triangle = tree.at(indexes, j);
+
+            for (int k = 0; k < 3; ++k)
+            {
+                const double number = tree.number(tree.at(triangle, k));
+                const int index = static_cast< int >(number);
+                assert(index >= 0 && index < tree.size(vertexes));
+                mesh.indexes.push_back(index);
+            }
+        }
+    }
+
+    animations_.resize(tree.size(animations));
+
+    for (int i = 0; i < tree.size(animations); ++i)
+    {
+        Animation::load(tree, tree.at(animations, i), &animations_.at(i));
+    }
+
+    skeletons_.resize(tree.size(trees));
+
+    for (int i = 0; i < tree.size(trees); ++i)
+    {
+        Skeleton::load(tree, tree.at(trees, i), &skeletons_.at(i));
+    }
+}
+
+Impl::~Impl() {}
+
+int Impl::add(const std::string& tree_id)
+{
+    int skeleton_index = 0;
+
+    while ( skeleton_index < static_cast< int >(skeletons_.size())
+            && skeletons_.at(skeleton_index).id() != tree_id)
+    {
+        ++skeleton_index;
+    }
+
+    assert(skeleton_index < static_cast< int >(skeletons_.size()));
+    const Skeleton* skeleton = &skeletons_.at(skeleton_index);
+    const int pose = static_cast< int >(firsts_.size());
+    const int first = static_cast< int >(parents_.size());
+    firsts_.push_back(first);
+    sizes_.push_back(skeleton->size());
+    skeletons_of_poses_.push_back(skeleton_index);
+    seconds_.push_back(0.0);
+    leaders_.push_back(pose);
+
+    for (int i = 0; i < skeleton->size(); ++i)
+    {
+        const int parent = skeleton->parent(i);
+        const int animation = find_animation(skeleton->animation_id(i));
+        parents_.push_back(parent < 0 ? -1 : first + parent);
+        poses_.push_back(pose);
+        node_meshes_.push_back(find_mesh(skeleton->model_id(i)));
+        node_animations_.push_back(animation);
+        positions_.push_back(skeleton->position(i));
+        angles_.push_back(skeleton->angle(i));
+        scales_.push_back(skeleton->scale(i));
+        locals_.push_back(Affine());
+        get_local(positions_.back(), angles_.back(), &locals_.back());
+        worlds_.push_back(Affine());
+
+        if (animation >= 0)
+        {
+            animated_.push_back(first + i);
+        }
+    }
+
+    return pose;
+}
+
+const Animation& Impl::clip(int i) const { return animations_.at(i); }
+
+int Impl::clip_count() const { return static_cast< int >(animations_.size()); }
+
+// The model matrix scales the world matrix of a node, and the clip matrix
+// is the perspective of it, so the vertexes are transformed once each.
+// The normals are of the triangles in the world, after the scale.
+void Impl::draw(int pose, const View& view)
+{
+    double perspective[4][4];
+    BatchTransform::get_rows(view.get_perspective_matrix(), perspective);
+    const Vector3& light = TheEnvironment::LightVector;
+    const Vector3& brightness = TheEnvironment::Brightness;
+    const double ambient = TheEnvironment::AmbientBrightness;
+
+    TheDrawQueue queue = TheDrawQueue::instance();
+    queue.texture(0);
+
+    const int end = firsts_.at(pose) + sizes_.at(pose);
+
+    for (int i = firsts_.at(pose); i < end; ++i)
+    {
+        if (node_meshes_.at(i) < 0)
+        {
+            continue;
+        }
+
+        const Mesh& mesh = meshes_.at(node_meshes_.at(i));
+        const Affine& world = worlds_.at(i);
+        const double scale[3]
+        = { scales_.at(i).x, scales_.at(i).y, scales_.at(i).z };
+        double model[4][4] = { { 0.0 } };
+        double clip[4][4];
+        model[3][3] = 1.0;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            for (int column = 0; column < 3; ++column)
+            {
+                model[row][column] = world.m[row][column] * scale[column];
+            }
+
+            model[row][3] = world.m[row][3];
+        }
+
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                clip[row][column]
+                = perspective[row][0] * model[0][column]
+                + perspective[row][1] * model[1][column]
+                + perspective[row][2] * model[2][column]
+                + perspective[row][3] * model[3][column];
+            }
+        }
+
+        const int size = static_cast< int >(mesh.xs.size());
+        world_points_.resize(std::max(world_points_.size(), mesh.xs.size()));
+        clip_points_.resize(std::max(clip_points_.size(), mesh.xs.size()));
+        BatchTransform::transform(  model,
+                                    &mesh.xs.at(0),
+                                    &mesh.ys.at(0),
+                                    &mesh.zs.at(0),
+                                    size,
+                                    &world_points_.at(0));
+        BatchTransform::transform(  clip,
+                                    &mesh.xs.at(0),
+                                    &mesh.ys.at(0),
+                                    &mesh.zs.at(0),
+                                    size,
+                                    &clip_points_.at(0));
+
+        for (size_t j = 0; j < mesh.indexes.size(); j = j + 3)
+        {
+            const int a = mesh.indexes.at(j);
+            const int b = mesh.indexes.at(j + 1);
+            const int c = mesh.indexes.at(j + 2);
+            const Vector3& p0 = world_points_.at(a);
+            const Vector3& p1 = world_points_.at(b);
+            const Vector3& p2 = world_points_.at(c);
+
+            // (p2 - p0) x (p1 - p0), outward for the models
+            const double ux = p2.x - p0.x;
+            const double uy = p2.y - p0.y;
+            const double uz = p2.z - p0.z;
+            const double vx = p1.x - p0.x;
+            const double vy = p1.y - p0.y;
+            const double vz = p1.z - p0.z;
+            Vector3 normal( uy * vz - uz * vy,
+                            uz * vx - ux * vz,
+                            ux * vy - uy * vx);
+
+            if (normal.length() == 0.0)
+            {
+                continue;
+            }
+
+            normal.normalize(1.0);
+            const double lambert = std::max(0.0, normal.dot(light));
+            const unsigned color
+            = 0xff000000
+            | to_channel(brightness.x * lambert + ambient) << 16
+            | to_channel(brightness.y * lambert + ambient) << 8
+            | to_channel(brightness.z * lambert + ambient);
+            queue.add_triangle( &clip_points_.at(a).x,
+                                &clip_points_.at(b).x,
+                                &clip_points_.at(c).x,
+                                0, 0, 0,
+                                color, color, color);
+        }
+
+        drawn_count_ = drawn_count_ + 1;
+    }
+}
+
+int Impl::find_animation(const std::string& id) const
+{
+    for (size_t i = 0; i < animations_.size() && !id.empty(); ++i)
+    {
+        if (animations_.at(i).id() == id)
+        {
+            return static_cast< int >(i);
+        }
+    }
+
+    assert(id.empty());
+    return -1;
+}
+
+int Impl::find_mesh(const std::string& id) const
+{
+    for (size_t i = 0; i < meshes_.size() && !id.empty(); ++i)
+    {
+        if (meshes_.at(i).id == id)
+        {
+            return static_cast< int >(i);
+        }
+    }
+
+    assert(id.empty());
+    return -1;
+}
+
+void Impl::print(std::ostringstream* oss) const
+{
+    *oss << "poses: ";
+    *oss << firsts_.size();
+    *oss << ", nodes: ";
+    *oss << parents_.size();
+    *oss << " (animated ";
+    *oss << animated_.size();
+    *oss << "), samples: ";
+    *oss << sample_count_;
+    *oss << " (shared nodes ";
+    *oss << shared_count_;
+    *oss << "), drawn: ";
+    *oss << drawn_count_;
+}
+
+void Impl::root(int pose, const Vector3& position, const Vector3& angle)
+{
+    const int i = firsts_.at(pose);
+    positions_.at(i) = position;
+    angles_.at(i) = angle;
+    get_local(position, angle, &locals_.at(i));
+}
+
+// The animated channels take the place of the ones at rest.  The poses of
+// the same tree at the same time have the same locals, so only the first
+// of them samples and the others copy.  Then as a parent is before its
+// children, the world matrix of the parent is done when a child reads it.
+void Impl::update(unsigned delta_ms)
+{
+    sampled_.clear();
+
+    for (size_t i = 0; i < seconds_.size(); ++i)
+    {
+        seconds_.at(i) = seconds_.at(i) + delta_ms / 1e3;
+        leaders_.at(i) = static_cast< int >(i);
+
+        for (size_t j = 0; j < sampled_.size(); ++j)
+        {
+            const int other = sampled_.at(j);
+
+            if (skeletons_of_poses_.at(other) == skeletons_of_poses_.at(i)
+                && seconds_.at(other) == seconds_.at(i))
+            {
+                leaders_.at(i) = other;
+                break;
+            }
+        }
+
+        if (leaders_.at(i) == static_cast< int >(i))
+        {
+            sampled_.push_back(static_cast< int >(i));
+        }
+    }
+
+    sample_count_ = 0;
+    shared_count_ = 0;
+
+    for (size_t i = 0; i < animated_.size(); ++i)
+    {
+        const int node = animated_.at(i);
+        const int pose = poses_.at(node);
+        const int leader = leaders_.at(pose);
+
+        if (leader != pose)
+        {
+            const int at = node - firsts_.at(pose) + firsts_.at(leader);
+            locals_.at(node) = locals_.at(at);
+            shared_count_ = shared_count_ + 1;
+            continue;
+        }
+
+        const Animation& animation = animations_.at(node_animations_.at(node));
+        const double seconds = seconds_.at(pose);
+        Vector3 position(positions_.at(node));
+        Vector3 angle(angles_.at(node));
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (animation.has(PositionChannels[axis]))
+            {
+                (&position.x)[axis]
+                = animation.sample(PositionChannels[axis], seconds);
+                sample_count_ = sample_count_ + 1;
+            }
+
+            if (animation.has(AngleChannels[axis]))
+            {
+                (&angle.x)[axis]
+                = animation.sample(AngleChannels[axis], seconds);
+                sample_count_ = sample_count_ + 1;
+            }
+        }
+
+        get_local(position, angle, &locals_.at(node));
+    }
+
+    const int size = static_cast< int >(parents_.size());
+
+    for (int i = 0; i < size; ++i)
+    {
+        const int parent = parents_[i];
+
+        if (parent < 0)
+        {
+            worlds_[i] = locals_[i];
+        }
+        else
+        {
+            multiply(worlds_[parent], locals_[i], &worlds_[i]);
+        }
+    }
+
+    drawn_count_ = 0;
+}
+
+Impl* g_impl = 0;
+
+} // namespace -
+
+void ThePoses::create()
+{
+    assert(!g_impl);
+    g_impl = new Impl();
+}
+
+void ThePoses::destroy()
+{
+    assert(g_impl);
+    delete g_impl;
+    g_impl = 0;
+}
+
+ThePoses ThePoses::instance() { return ThePoses(); }
+
+bool ThePoses::did_create() { return !!g_impl; }
+
+ThePoses::ThePoses() {}
+
+ThePoses::~ThePoses() {}
+
+int ThePoses::add(const std::string& tree_id) const
+{
+    return g_impl->add(tree_id);
+}
+
+const Animation& ThePoses::clip(int i) const { return g_impl->clip(i); }
+
+int ThePoses::clip_count() const { return g_impl->clip_count(); }
+
+void ThePoses::draw(int pose, const View& view) const
+{
+    g_impl->draw(pose, view);
+}
+
+void ThePoses::print(std::ostringstream* oss) const { g_impl->print(oss); }
+
+void ThePoses::root(    int pose,
+                        const Vector3& position,
+                        const Vector3& angle) const
+{
+    g_impl->root(pose, position, angle);
+}
+
+void ThePoses::update(unsigned delta_ms) const { g_impl->update(delta_ms); }
@@ -0,0 +1,41 @@
+#ifndef ROBOFTHEPOSES_H_
+#define ROBOFTHEPOSES_H_
+#include <sstream>
+#include <string>
+
+namespace GraphicsDatabase { class Vector3; }
+
+class Animation;
+class View;
+
+using GraphicsDatabase::Vector3;
+
+// The animated trees of data/models.json, drawn with the flat shading.  A
+// pose is an instance of a tree, its nodes flattened next to the ones of
+// the other poses, each after its parent.  So one pass in the order of the
+// nodes makes the world matrices of all of them, and a draw reads those.
+// The poses of a tree at the same time of the animations share them.
+class ThePoses
+{
+public:
+    static void create();
+    static void destroy();
+    static ThePoses instance();
+    static bool did_create();
+
+private:
+    ThePoses();
+
+public:
+    ~ThePoses();
+    int add(const std::string& tree_id) const; // the pose, kept until destroy
+    const Animation& clip(int i) const;
+    int clip_count() const;
+    void draw(int pose, const View& view) const;
+    void print(std::ostringstream* oss) const;
+    // the balance and the angle of the tree
+    void root(int pose, const Vector3& position, const Vector3& angle) const;
+    void update(unsigned delta_ms) const;
+};
+
+#endif
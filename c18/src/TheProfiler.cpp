@@ -0,0 +1,299 @@
+#include "TheProfiler.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "TheDebugOutput.h"
+
+namespace
+{
+
+const int MaxThreads = 16; // the ones after them are not recorded
+const unsigned RingSize = 8192; // zones of a thread
+const int MaxDepth = 16; // the deeper zones are not recorded
+const int MaxSummaryLines = 24;
+const int SummaryLineSize = 128;
+
+struct Event
+{
+    const char* name;
+    long long begin_ns;
+    long long end_ns;
+    int depth;
+};
+
+// Written by the owner only.  The head is published after the event, so
+// the events under it can be read by the other threads.
+struct Ring
+{
+    std::atomic< bool > is_claimed; // by a thread, for good
+    std::atomic< unsigned > head; // the events written so far
+    Event events[RingSize];
+    // the open zones
+    const char* names[MaxDepth];
+    long long begins[MaxDepth];
+    int depth;
+};
+
+struct Total
+{
+    const char* name;
+    int depth;
+    long long first_ns;
+    long long ns;
+    int count;
+};
+
+Ring g_rings[MaxThreads];
+thread_local Ring* g_thread_ring = 0; // of the calling thread
+thread_local bool g_has_claimed = false; // or tried to, all may be taken
+const Ring* g_frame_ring = 0; // the one of the thread of the frames
+unsigned g_frame_head = 0; // of it, at the start of the frame
+char g_summary[MaxSummaryLines][SummaryLineSize];
+int g_summary_count = 0;
+
+long long now_ns()
+{
+    using namespace std::chrono;
+    const steady_clock::duration time = steady_clock::now().time_since_epoch();
+    return duration_cast< nanoseconds >(time).count();
+}
+
+const long long g_epoch_ns = now_ns();
+
+// claims a free ring the first time a thread records, then keeps it, so
+// the zones pay only for the clock
+Ring* find_ring()
+{
+    if (g_has_claimed)
+    {
+        return g_thread_ring;
+    }
+
+    g_has_claimed = true;
+
+    for (int i = 0; i < MaxThreads && !g_thread_ring; ++i)
+    {
+        if (!g_rings[i].is_claimed.exchange(true, std::memory_order_acq_rel))
+        {
+            g_thread_ring = &g_rings[i];
+        }
+    }
+
+    return g_thread_ring;
+}
+
+// the events which are not overwritten yet
+unsigned get_first(unsigned first, unsigned head)
+{
+    return head - first > RingSize ? head - RingSize : first;
+}
+
+// in the order they began, the outer ones first
+bool is_before(const Total& a, const Total& b)
+{
+    return a.first_ns < b.first_ns
+        || (a.first_ns == b.first_ns && a.depth < b.depth);
+}
+
+} // namespace -
+
+TheProfiler::Zone::Zone(const char* name) { TheProfiler::begin(name); }
+
+TheProfiler::Zone::~Zone() { TheProfiler::end(); }
+
+void TheProfiler::begin(const char* name)
+{
+    Ring* ring = find_ring();
+
+    if (!ring)
+    {
+        return;
+    }
+
+    if (ring->depth < MaxDepth)
+    {
+        ring->names[ring->depth] = name;
+        ring->begins[ring->depth] = now_ns();
+    }
+
+    ring->depth = ring->depth + 1;
+}
+
+void TheProfiler::end()
+{
+    Ring* ring = find_ring();
+
+    if (!ring)
+    {
+        return;
+    }
+
+    assert(ring->depth > 0);
+    ring->depth = ring->depth - 1;
+
+    if (ring->depth >= MaxDepth)
+    {
+        return;
+    }
+
+    const unsigned head = ring->head.load(std::memory_order_relaxed);
+    Event& event = ring->events[head % RingSize];
+    event.name = ring->names[ring->depth];
+    event.begin_ns = ring->begins[ring->depth];
+    event.end_ns = now_ns();
+    event.depth = ring->depth;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+// The zones of the same name and depth are added up.  A frame has a few of
+// them, so a linear search and an insertion sort are enough.
+void TheProfiler::end_frame()
+{
+    const Ring* ring = find_ring();
+
+    if (!ring)
+    {
+        return;
+    }
+
+    const unsigned head = ring->head.load(std::memory_order_acquire);
+    const unsigned first = ring == g_frame_ring ? g_frame_head : head;
+    g_frame_ring = ring;
+    g_frame_head = head;
+
+    Total totals[MaxSummaryLines];
+    int count = 0;
+
+    for (unsigned i = get_first(first, head); i != head; ++i)
+    {
+        const Event& event = ring->events[i % RingSize];
+        int found = 0;
+
+        while (found < count
+               && (totals[found].depth != event.depth
+                   || std::strcmp(totals[found].name, event.name) != 0))
+        {
+            ++found;
+        }
+
+        if (found == count && count == MaxSummaryLines)
+        {
+            continue;
+        }
+
+        if (found == count)
+        {
+            const Total total = {   event.name,
+                                    event.depth,
+                                    event.begin_ns,
+                                    0,
+                                    0 };
+            totals[count] = total;
+            ++count;
+        }
+
+        Total& total = totals[found];
+        total.first_ns
+        = event.begin_ns < total.first_ns ? event.begin_ns : total.first_ns;
+        total.ns = total.ns + event.end_ns - event.begin_ns;
+        total.count = total.count + 1;
+    }
+
+    for (int i = 1; i < count; ++i)
+    {
+        const Total total = totals[i];
+        int j = i;
+
+        for (; j > 0 && is_before(total, totals[j - 1]); --j)
+        {
+            totals[j] = totals[j - 1];
+        }
+
+        totals[j] = total;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Total& total = totals[i];
+        std::snprintf(  g_summary[i],
+                        sizeof(g_summary[i]),
+                        total.count > 1 ? "%*s%.32s: %.3f ms (%d)"
+                                        : "%*s%.32s: %.3f ms",
+                        total.depth * 2,
+                        "",
+                        total.name,
+                        total.ns / 1e6,
+                        total.count);
+    }
+
+    g_summary_count = count;
+}
+
+void TheProfiler::print()
+{
+    for (int i = 0; i < g_summary_count; ++i)
+    {
+        const char* const line = g_summary[i]; // not the template for arrays
+        TheDebugOutput::print(line);
+    }
+}
+
+// The complete events of the trace event format, in microseconds from the
+// start.  The names are the literals of the zones, so they are not escaped.
+bool TheProfiler::save(const char* filename)
+{
+    std::ofstream file(filename);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "{\"traceEvents\":[";
+    bool is_first = true;
+    char line[256];
+
+    for (int i = 0; i < MaxThreads; ++i)
+    {
+        const Ring& ring = g_rings[i];
+
+        if (!ring.is_claimed.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        std::snprintf(  line,
+                        sizeof(line),
+                        "%s\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                        "\"pid\":1,\"tid\":%d,"
+                        "\"args\":{\"name\":\"%s %d\"}}",
+                        is_first ? "" : ",",
+                        i,
+                        &ring == g_frame_ring ? "frames" : "thread",
+                        i);
+        file << line;
+        is_first = false;
+
+        const unsigned head = ring.head.load(std::memory_order_acquire);
+
+        for (unsigned j = get_first(0, head); j != head; ++j)
+        {
+            const Event& event = ring.events[j % RingSize];
+            std::snprintf(  line,
+                            sizeof(line),
+                            ",\n{\"name\":\"%.64s\",\"ph\":\"X\","
+                            "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                            event.name,
+                            (event.begin_ns - g_epoch_ns) / 1e3,
+                            (event.end_ns - event.begin_ns) / 1e3,
+                            i);
+            file << line;
+        }
+    }
+
+    file << "\n]}\n";
+    return !!file;
+}
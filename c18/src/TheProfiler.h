@@ -0,0 +1,33 @@
+#ifndef ROBOFTHEPROFILER_H_
+#define ROBOFTHEPROFILER_H_
+
+// The zones of the frames, nested, timed in nanoseconds.  Each thread
+// records into its own ring, so a zone takes no lock, and the oldest ones
+// are overwritten.  The zones of the main thread are summed up by the end
+// of a frame for the screen, and all of them can be saved as a trace of
+// Chrome or Perfetto.
+class TheProfiler
+{
+public:
+    // a zone from the construction to the destruction
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+
+    private:
+        Zone(const Zone&);
+        Zone& operator=(const Zone&);
+    };
+
+public:
+    static void begin(const char* name); // the name is kept, not copied
+    static void end();
+    // sums up the zones of the frame, on the thread which calls it
+    static void end_frame();
+    static void print(); // the summary of the last frame, to the screen
+    static bool save(const char* filename); // as the JSON of a trace
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "TheTime.h"
 #include "GameLib/Framework.h"
+#include "Platform.h"
 
 namespace
 {
@@ -24,8 +25,7 @@ Impl::Impl()
 :   rate_(1.0),
     delta_(0), now_(0), previous_(0)
 {
-    GameLib::Framework f = GameLib::Framework::instance();
-    now_ = f.time();
+    now_ = Platform::time();
 }
 
 double Impl::rate() const { return rate_; }
@@ -36,9 +36,8 @@ unsigned Impl::delta() const { return delta_; }
 
 void Impl::tick()
 {
-    GameLib::Framework f = GameLib::Framework::instance();
     previous_ = now_;
-    now_ = f.time();
+    now_ = Platform::time();
     delta_ = static_cast< unsigned >((now_ - previous_) * rate_);
 }
 
@@ -0,0 +1,61 @@
+#include "Tokenizer.h"
+#include <cassert>
+#include <cctype>
+#include <string>
+
+Tokenizer::Tokenizer(const std::string& text)
+: text_(text), at_(0)
+{}
+
+std::string Tokenizer::next()
+{
+    while (at_ < text_.size())
+    {
+        if (std::isspace(static_cast< unsigned char >(text_.at(at_))))
+        {
+            ++at_;
+        }
+        else if (text_.compare(at_, 2, "//") == 0)
+        {
+            at_ = text_.find('\n', at_);
+            at_ = at_ == std::string::npos ? text_.size() : at_;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (at_ >= text_.size())
+    {
+        return std::string();
+    }
+
+    const size_t from = at_;
+    const char c = text_.at(at_);
+
+    if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')
+    {
+        ++at_;
+        return text_.substr(from, 1);
+    }
+
+    if (c == '"')
+    {
+        const size_t to = text_.find('"', from + 1);
+        assert(to != std::string::npos);
+        at_ = to + 1;
+        return text_.substr(from, to - from + 1);
+    }
+
+    while ( at_ < text_.size()
+            && (std::isalnum(static_cast< unsigned char >(text_.at(at_)))
+                || text_.at(at_) == '_' || text_.at(at_) == '.'
+                || text_.at(at_) == '-' || text_.at(at_) == '+'))
+    {
+        ++at_;
+    }
+
+    assert(at_ > from);
+    return text_.substr(from, at_ - from);
+}
@@ -0,0 +1,19 @@
+#ifndef ROBOFTOKENIZER_H_
+#define ROBOFTOKENIZER_H_
+#include <string>
+
+// Reads the pseudo json of data/*.json: bare keys, double quoted strings,
+// numbers, // comments and trailing commas.  A token is a punctuation, a
+// quoted string with the quotes, or a bare word; empty at the end.
+class Tokenizer
+{
+private:
+    const std::string& text_;
+    size_t at_;
+
+public:
+    Tokenizer(const std::string& text);
+    std::string next();
+};
+
+#endif
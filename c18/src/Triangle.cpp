@@ -10,6 +10,99 @@ Triangle::Triangle(const Vector3& q0, const Vector3& q1, const Vector3& q2)
 
 Triangle::~Triangle() {}
 
+// walk the voronoi regions of the vertexes, the edges and the face
+Vector3 Triangle::get_closest_point(const Vector3& point) const
+{
+    Vector3 ab(p1);
+    ab.subtract(p0);
+    Vector3 ac(p2);
+    ac.subtract(p0);
+    Vector3 ap(point);
+    ap.subtract(p0);
+
+    const double d1 = ab.dot(ap);
+    const double d2 = ac.dot(ap);
+
+    if (d1 <= 0.0 && d2 <= 0.0)
+    {
+        return p0;
+    }
+
+    Vector3 bp(point);
+    bp.subtract(p1);
+    const double d3 = ab.dot(bp);
+    const double d4 = ac.dot(bp);
+
+    if (d3 >= 0.0 && d4 <= d3)
+    {
+        return p1;
+    }
+
+    const double vc = d1 * d4 - d3 * d2;
+
+    if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+        Vector3 on_ab(ab);
+        on_ab.multiply(d1 / (d1 - d3));
+        on_ab.add(p0);
+        return on_ab;
+    }
+
+    Vector3 cp(point);
+    cp.subtract(p2);
+    const double d5 = ab.dot(cp);
+    const double d6 = ac.dot(cp);
+
+    if (d6 >= 0.0 && d5 <= d6)
+    {
+        return p2;
+    }
+
+    const double vb = d5 * d2 - d1 * d6;
+
+    if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+        Vector3 on_ac(ac);
+        on_ac.multiply(d2 / (d2 - d6));
+        on_ac.add(p0);
+        return on_ac;
+    }
+
+    const double va = d3 * d6 - d5 * d4;
+
+    if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+        Vector3 on_bc(p2);
+        on_bc.subtract(p1);
+        on_bc.multiply((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        on_bc.add(p1);
+        return on_bc;
+    }
+
+    const double denominator = 1.0 / (va + vb + vc);
+    ab.multiply(vb * denominator);
+    ac.multiply(vc * denominator);
+
+    Vector3 on_face(p0);
+    on_face.add(ab);
+    on_face.add(ac);
+    return on_face;
+}
+
+Vector3 Triangle::normal() const
+{
+    Vector3 n(p1);
+    n.subtract(p0);
+
+    Vector3 e(p2);
+    e.subtract(p0);
+
+    n.cross_product(e);
+    n.normalize(1.0);
+
+    return n;
+}
+
 void Triangle::print(std::ostringstream* oss) const
 {
     *oss << "{";
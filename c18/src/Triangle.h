@@ -13,6 +13,8 @@ public:
 public:
     Triangle(const Vector3& q0, const Vector3& q1, const Vector3& q2);
     ~Triangle();
+    Vector3 get_closest_point(const Vector3& point) const;
+    Vector3 normal() const;
     void print(std::ostringstream* oss) const;
 };
 
@@ -5,6 +5,7 @@
 #include "GraphicsDatabase/Camera.h"
 #include "GraphicsDatabase/Matrix44.h"
 #include "GraphicsDatabase/Vector3.h"
+#include "Frustum.h"
 #include "Robo.h"
 #include "TheTime.h"
 
@@ -21,11 +22,18 @@ const Vector3 AnglePerMs(0.1, 0.1, 0.1);
 const double AngleOfView        = 90.0;
 const double AngleOfViewPerMs   = 0.10;
 
+bool is_same(const Vector3& a, const Vector3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
 } // namespace -
 
 View::View(int width, int height, double near_clip, double far_clip)
 :   camera_(),
-    delta_angle_(0.0, 0.0, 0.0)
+    delta_angle_(0.0, 0.0, 0.0),
+    frustum_(),
+    revision_(0)
 {
     camera_.near_clip(near_clip);
     camera_.far_clip(far_clip);
@@ -34,6 +42,7 @@ View::View(int width, int height, double near_clip, double far_clip)
     camera_.angle_of_view(AngleOfView);
     camera_.angle(FirstAngle);
     camera_.position(FirstPosition);
+    frustum_ = Frustum(camera_.get_perspective_matrix());
 }
 
 View::~View() {}
@@ -58,6 +67,8 @@ void View::decrease_angle_of_view(int a)
     double angle_of_view
     = camera_.angle_of_view() - static_cast< double >(delta) * AngleOfViewPerMs;
     camera_.angle_of_view(angle_of_view);
+    frustum_ = Frustum(camera_.get_perspective_matrix());
+    revision_ = revision_ + 1;
 }
 
 void View::follow(const Robo& robo)
@@ -77,15 +88,27 @@ void View::follow(const Robo& robo)
     diff.multiply(0.4); // follow rate
 
     current.add(diff);
+    const bool did_move = !is_same(current, *camera_.position());
     camera_.position(current);
 
     // follow angle
     Vector3 angle;
     angle.y = -robo.angle_zx() + 180.0;
     angle.add(delta_angle_);
+    const bool did_turn = !is_same(angle, *camera_.angle());
     camera_.angle(angle);
+
+    if (did_move || did_turn)
+    {
+        revision_ = revision_ + 1;
+    }
+
+    // once a frame, so the counts of the culling are of a frame
+    frustum_ = Frustum(camera_.get_perspective_matrix());
 }
 
+const Frustum* View::frustum() const { return &frustum_; }
+
 Matrix44 View::get_perspective_matrix() const
 {
     return camera_.get_perspective_matrix();
@@ -97,6 +120,8 @@ void View::increase_angle_of_view(int a)
     double angle_of_view
     = camera_.angle_of_view() + static_cast< double >(delta) * AngleOfViewPerMs;
     camera_.angle_of_view(angle_of_view);
+    frustum_ = Frustum(camera_.get_perspective_matrix());
+    revision_ = revision_ + 1;
 }
 
 void View::print(std::ostringstream* oss) const
@@ -118,6 +143,8 @@ void View::print(std::ostringstream* oss) const
     *oss << "}";
 }
 
+unsigned View::revision() const { return revision_; }
+
 void View::rotate(const Vector3& diff)
 {
     Vector3 angle(diff);
@@ -3,6 +3,7 @@
 #include <sstream>
 #include "GraphicsDatabase/Camera.h"
 #include "GraphicsDatabase/Vector3.h"
+#include "Frustum.h"
 
 namespace GraphicsDatabase { class Matrix44; }
 class Robo;
@@ -15,6 +16,8 @@ class View
 private:
     GraphicsDatabase::Camera camera_;
     Vector3 delta_angle_;
+    Frustum frustum_;
+    unsigned revision_;
 
 public:
     View(int width, int height, double near_clip, double far_clip);
@@ -25,9 +28,11 @@ public:
     const Vector3* center() const;
     void decrease_angle_of_view(int a);
     void follow(const Robo& robo);
+    const Frustum* frustum() const;
     Matrix44 get_perspective_matrix() const;
     void increase_angle_of_view(int a);
     void print(std::ostringstream* oss) const;
+    unsigned revision() const; // changes when the camera does
     void rotate(const Vector3& diff);
 };
 
@@ -1,9 +1,13 @@
 #include "Wall.h"
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <vector>
 #include "GraphicsDatabase/Matrix44.h"
 #include "GraphicsDatabase/Model.h"
 #include "GraphicsDatabase/Vector3.h"
+#include "Frustum.h"
+#include "Sphere.h"
 #include "TheDatabase.h"
 #include "TheEnvironment.h"
 #include "Triangle.h"
@@ -40,14 +44,38 @@ void make_triangles_from_model( std::vector< Triangle >* triangles,
     }
 }
 
+// around the position of the model, by its farthest vertex
+Sphere make_bounding_sphere(const std::vector< Triangle >& triangles,
+                            const Model& model)
+{
+    const Vector3& balance = *(model.position());
+    double radius2 = 0.0;
+
+    for (size_t i = 0; i < triangles.size(); ++i)
+    {
+        const Vector3* points[3]
+        = { &triangles.at(i).p0, &triangles.at(i).p1, &triangles.at(i).p2 };
+
+        for (int j = 0; j < 3; ++j)
+        {
+            Vector3 to_point(*points[j]);
+            to_point.subtract(balance);
+            radius2 = std::max(radius2, to_point.squared_length());
+        }
+    }
+
+    return Sphere(balance, std::sqrt(radius2));
+}
+
 } // namespace -
 
 Wall::Wall(const std::string& id)
-: model_(0), triangles_()
+: model_(0), triangles_(), bounding_sphere_()
 {
     TheDatabase::instance().create_model(id, "rhombus");
     model_ = TheDatabase::instance().find_model(id);
     make_triangles_from_model(&triangles_, *model_);
+    bounding_sphere_ = make_bounding_sphere(triangles_, *model_);
 }
 
 Wall::~Wall()
@@ -58,6 +86,11 @@ Wall::~Wall()
 
 void Wall::draw(const View& view) const
 {
+    if (!view.frustum()->contains(bounding_sphere_))
+    {
+        return;
+    }
+
     model_->draw(   view.get_perspective_matrix(),
                     TheEnvironment::Brightness,
                     TheEnvironment::AmbientBrightness,
@@ -73,4 +106,5 @@ void Wall::warp(const Vector3& position)
 {
     model_->position(position);
     make_triangles_from_model(&triangles_, *model_);
+    bounding_sphere_ = make_bounding_sphere(triangles_, *model_);
 }
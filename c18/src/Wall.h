@@ -2,6 +2,7 @@
 #define ROBOFWALL_H_
 #include <string>
 #include <vector>
+#include "Sphere.h"
 
 namespace GraphicsDatabase { class Model; }
 namespace GraphicsDatabase { class Vector3; }
@@ -16,6 +17,7 @@ class Wall
 private:
     Model* model_;
     std::vector< Triangle > triangles_;
+    Sphere bounding_sphere_;
 
 public:
     Wall(const std::string& id);
@@ -0,0 +1,232 @@
+#include "WeaponProfile.h"
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Ai/FirePattern.h"
+#include "Tokenizer.h"
+
+WeaponProfile::WeaponProfile()
+:   id(),
+    kind(KindBallistic),
+    speed0(50.0),
+    speed_max(50.0),
+    boost_after_ms(0),
+    boost_ms(0),
+    abs_angle_limit(0.0),
+    active_angle_limit(0.0),
+    max_age_ms(10000),
+    damage(0.01),
+    radius(0.1),
+    can_intercept(false),
+    pattern()
+{}
+
+WeaponProfile::~WeaponProfile() {}
+
+double WeaponProfile::delta_speed() const
+{
+    if (boost_ms == 0)
+    {
+        return 0.0;
+    }
+
+    return (speed_max - speed0) / (static_cast< double >(boost_ms) / 1e3);
+}
+
+// as far as a bullet of the speed goes in the max age
+double WeaponProfile::range() const
+{
+    return speed0 * static_cast< double >(max_age_ms) / 1e3;
+}
+
+namespace
+{
+
+std::string unquote(const std::string& token)
+{
+    if (token.size() >= 2 && token.at(0) == '"')
+    {
+        return token.substr(1, token.size() - 2);
+    }
+
+    return token;
+}
+
+WeaponProfile::Kind to_kind(const std::string& name)
+{
+    if (name == "boosted")
+    {
+        return WeaponProfile::KindBoosted;
+    }
+    else if (name == "homing")
+    {
+        return WeaponProfile::KindHoming;
+    }
+    else if (name == "beam")
+    {
+        return WeaponProfile::KindBeam;
+    }
+
+    assert(name == "ballistic");
+    return WeaponProfile::KindBallistic;
+}
+
+Ai::FirePattern::Shape to_shape(const std::string& name)
+{
+    if (name == "fan")
+    {
+        return Ai::FirePattern::ShapeFan;
+    }
+    else if (name == "ring")
+    {
+        return Ai::FirePattern::ShapeRing;
+    }
+    else if (name == "burst")
+    {
+        return Ai::FirePattern::ShapeBurst;
+    }
+
+    assert(name == "single");
+    return Ai::FirePattern::ShapeSingle;
+}
+
+void set(   WeaponProfile* profile,
+            const std::string& key,
+            const std::string& value)
+{
+    const double number = std::atof(value.c_str());
+    const unsigned ms = static_cast< unsigned >(number);
+    Ai::FirePattern* pattern = &profile->pattern;
+
+    if (key == "id")
+    {
+        profile->id = value;
+    }
+    else if (key == "kind")
+    {
+        profile->kind = to_kind(value);
+    }
+    else if (key == "speed0")
+    {
+        profile->speed0 = number;
+    }
+    else if (key == "speed_max")
+    {
+        profile->speed_max = number;
+    }
+    else if (key == "boost_after_ms")
+    {
+        profile->boost_after_ms = ms;
+    }
+    else if (key == "boost_ms")
+    {
+        profile->boost_ms = ms;
+    }
+    else if (key == "abs_angle_limit")
+    {
+        profile->abs_angle_limit = number;
+    }
+    else if (key == "active_angle_limit")
+    {
+        profile->active_angle_limit = number;
+    }
+    else if (key == "max_age_ms")
+    {
+        profile->max_age_ms = ms;
+    }
+    else if (key == "damage")
+    {
+        profile->damage = number;
+    }
+    else if (key == "radius")
+    {
+        profile->radius = number;
+    }
+    else if (key == "can_intercept")
+    {
+        profile->can_intercept = value == "true";
+    }
+    else if (key == "pattern")
+    {
+        pattern->shape = to_shape(value);
+    }
+    else if (key == "rounds")
+    {
+        pattern->rounds = static_cast< int >(number);
+    }
+    else if (key == "spread")
+    {
+        pattern->spread = number;
+    }
+    else if (key == "spacing")
+    {
+        pattern->spacing = number;
+    }
+    else if (key == "jitter")
+    {
+        pattern->jitter = number;
+    }
+    else if (key == "seed")
+    {
+        pattern->seed = ms;
+    }
+    else
+    {
+        assert(!"unknown weapon key");
+    }
+}
+
+} // namespace -
+
+// only the flat objects in the "weapons" array are read
+void WeaponProfile::load(   const std::string& filename,
+                            std::vector< WeaponProfile >* profiles)
+{
+    std::ifstream file(filename.c_str());
+    assert(file);
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    const std::string text = oss.str();
+
+    Tokenizer tokenizer(text);
+    std::string token = tokenizer.next();
+
+    while (!token.empty() && token != "weapons")
+    {
+        token = tokenizer.next();
+    }
+
+    token = tokenizer.next();
+    assert(token == ":");
+    token = tokenizer.next();
+    assert(token == "[");
+
+    for (token = tokenizer.next(); token == "{"; token = tokenizer.next())
+    {
+        WeaponProfile profile;
+
+        for (token = tokenizer.next(); token != "}"; token = tokenizer.next())
+        {
+            if (token == ",")
+            {
+                continue;
+            }
+
+            const std::string key = token;
+            token = tokenizer.next();
+            assert(token == ":");
+            set(&profile, key, unquote(tokenizer.next()));
+        }
+
+        profiles->push_back(profile);
+        token = tokenizer.next(); // "," or "]"
+
+        if (token != ",")
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef ROBOFWEAPONPROFILE_H_
+#define ROBOFWEAPONPROFILE_H_
+#include <string>
+#include <vector>
+#include "Ai/FirePattern.h"
+
+class WeaponProfile
+{
+public:
+    // every kind has its own bullet pool and update kernel
+    enum Kind
+    {
+        KindBallistic,  // gravity only
+        KindBoosted,    // gravity and a boost after a while
+        KindHoming,     // boosted, and steers to the opponent
+        KindBeam,       // a ray of the range, hits in the frame it is fired
+        KindSize,
+    };
+
+public:
+    std::string id;
+    Kind kind;
+    double speed0; // [m/s]
+    double speed_max; // [m/s], after the boost
+    unsigned boost_after_ms;
+    unsigned boost_ms;
+    double abs_angle_limit; // [degree]
+    double active_angle_limit; // [degree]
+    unsigned max_age_ms;
+    double damage;
+    double radius; // [m], to hit the other bullets
+    bool can_intercept; // hits the bullets of the others
+    Ai::FirePattern pattern;
+
+public:
+    static void load(   const std::string& filename,
+                        std::vector< WeaponProfile >* profiles);
+
+public:
+    WeaponProfile();
+    ~WeaponProfile();
+    double delta_speed() const; // [m/s^2], while boosting
+    double range() const; // [m], of a beam
+};
+
+#endif
@@ -0,0 +1,143 @@
+// The errors of FastMath against the standard library, over the ranges of
+// the game: the angles of the robos and the bullets, a few turns either
+// way, and the directions of the velocities and the distances in the arena.
+// Fails when an error is over the bound of FastMath.h.
+#include <cmath>
+#include <cstdio>
+#include "FastMath.h"
+
+namespace
+{
+
+const double Pi         = 3.14159265358979323846;
+const double RadPerDeg  = Pi / 180.0;
+const double DegPerRad  = 180.0 / Pi;
+const double MaxDegree  = 720.0;
+const int AngleSteps    = 1000000;
+const int DirectionSteps = 100000;
+const double Magnitudes[] = { 1e-3, 1.0, 60.0, 1e3 }; // [m] or [m/s]
+const int MagnitudeSize = sizeof(Magnitudes) / sizeof(Magnitudes[0]);
+const double SinCosBound = 1e-10;
+const double Atan2Bound = 1e-6; // [degree]
+
+class Error
+{
+public:
+    double max;
+    double sum;
+    int count;
+    bool are_lanes_same; // as the scalar results
+
+public:
+    Error() : max(0.0), sum(0.0), count(0), are_lanes_same(true) {}
+
+    void add(double result, double expected)
+    {
+        const double error = std::abs(result - expected);
+        max = error > max ? error : max;
+        sum = sum + error;
+        ++count;
+    }
+
+    bool report(const char* name, double bound) const
+    {
+        const bool is_ok = max < bound && are_lanes_same;
+        std::printf(    "%-6s max %.3e mean %.3e bound %.0e lanes %s: %s\n",
+                        name,
+                        max,
+                        count > 0 ? sum / count : 0.0,
+                        bound,
+                        are_lanes_same ? "same" : "differ",
+                        is_ok ? "ok" : "FAILED");
+        return is_ok;
+    }
+};
+
+void test_sin_cos(Error* sin_error, Error* cos_error)
+{
+    double degrees[8];
+    double sines[8];
+    double cosines[8];
+
+    for (int i = 0; i < AngleSteps; i = i + 8)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            degrees[j] = -MaxDegree + 2.0 * MaxDegree * (i + j) / AngleSteps;
+        }
+
+        FastMath::sin8(degrees, sines);
+        FastMath::cos8(degrees, cosines);
+
+        for (int j = 0; j < 8; ++j)
+        {
+            const double degree = degrees[j];
+            sin_error->add(FastMath::sin(degree), std::sin(degree * RadPerDeg));
+            cos_error->add(FastMath::cos(degree), std::cos(degree * RadPerDeg));
+            sin_error->are_lanes_same = sin_error->are_lanes_same
+                                        && sines[j] == FastMath::sin(degree);
+            cos_error->are_lanes_same = cos_error->are_lanes_same
+                                        && cosines[j] == FastMath::cos(degree);
+        }
+    }
+}
+
+// around the circle, with the axes and the diagonals on the steps
+void test_atan2(Error* error)
+{
+    double ys[4];
+    double xs[4];
+    double results[4];
+
+    for (int m = 0; m < MagnitudeSize; ++m)
+    {
+        for (int i = 0; i < DirectionSteps; i = i + 4)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                const double angle = 2.0 * Pi * (i + j) / DirectionSteps;
+                ys[j] = Magnitudes[m] * std::sin(angle);
+                xs[j] = Magnitudes[m] * std::cos(angle);
+            }
+
+            FastMath::atan2_4(ys, xs, results);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                const double result = FastMath::atan2(ys[j], xs[j]);
+                double expected = std::atan2(ys[j], xs[j]) * DegPerRad;
+
+                // both ends of the cut are the same direction
+                if (std::abs(result - expected) > 180.0)
+                {
+                    expected = expected + (result > expected ? 360.0 : -360.0);
+                }
+
+                error->add(result, expected);
+                error->are_lanes_same = error->are_lanes_same
+                                        && results[j] == result;
+            }
+        }
+    }
+
+    error->add(FastMath::atan2(0.0, 0.0), std::atan2(0.0, 0.0));
+}
+
+} // namespace -
+
+int main()
+{
+    Error sin_error;
+    Error cos_error;
+    Error atan2_error;
+
+    test_sin_cos(&sin_error, &cos_error);
+    test_atan2(&atan2_error);
+
+    bool is_ok = true;
+    is_ok = sin_error.report("sin", SinCosBound) && is_ok;
+    is_ok = cos_error.report("cos", SinCosBound) && is_ok;
+    is_ok = atan2_error.report("atan2", Atan2Bound) && is_ok;
+
+    return is_ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+// The scenes of the headless backend drawn by the Rasterizer against the
+// reference TGAs of test/reference: the shading, a perspective texture,
+// the depth test, the blends and the clip by the near plane, with one and
+// with more threads.  A scene which differs is saved to the current
+// directory; --update saves the references instead, to review and commit.
+// rasterizer_test <c18 dir> [--update]
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "Image.h"
+#include "Rasterizer.h"
+
+namespace
+{
+
+const int Width         = 100; // not a whole count of the tiles
+const int Height        = 70;
+const int ThreadCounts[] = { 1, 4 };
+const int ThreadCountSize = sizeof(ThreadCounts) / sizeof(ThreadCounts[0]);
+const int Tolerance     = 1; // in a channel, for the rounding
+const unsigned Background = 0xff203040;
+
+// a vertex of the clip space and its uv
+class Vertex
+{
+public:
+    double p[4];
+    double t[2];
+    unsigned color;
+
+public:
+    Vertex( double x, double y, double z, double w,
+            double u, double v, unsigned vertex_color)
+    :   color(vertex_color)
+    {
+        p[0] = x;
+        p[1] = y;
+        p[2] = z;
+        p[3] = w;
+        t[0] = u;
+        t[1] = v;
+    }
+};
+
+void add(   Rasterizer* rasterizer,
+            const Vertex& v0,
+            const Vertex& v1,
+            const Vertex& v2,
+            bool is_textured)
+{
+    rasterizer->add_triangle(   v0.p, v1.p, v2.p,
+                                is_textured ? v0.t : 0,
+                                is_textured ? v1.t : 0,
+                                is_textured ? v2.t : 0,
+                                v0.color, v1.color, v2.color);
+}
+
+// a color for each vertex, either winding, and edges shared by two
+void draw_shaded(Rasterizer* rasterizer, const Image&)
+{
+    rasterizer->blend_mode(Rasterizer::BlendOpaque);
+    add(rasterizer,
+        Vertex(-0.9, -0.8, 0.5, 1.0, 0.0, 0.0, 0xffff0000),
+        Vertex(0.1, 0.9, 0.5, 1.0, 0.0, 0.0, 0xff00ff00),
+        Vertex(0.7, -0.6, 0.5, 1.0, 0.0, 0.0, 0xff0000ff),
+        false);
+    add(rasterizer,
+        Vertex(0.7, -0.6, 0.5, 1.0, 0.0, 0.0, 0xffffff00),
+        Vertex(0.1, 0.9, 0.5, 1.0, 0.0, 0.0, 0xff00ffff),
+        Vertex(0.95, 0.8, 0.5, 1.0, 0.0, 0.0, 0xffff00ff),
+        false);
+}
+
+// a floor going away, the texture is wrapped 4 times
+void draw_textured(Rasterizer* rasterizer, const Image& texture)
+{
+    rasterizer->blend_mode(Rasterizer::BlendOpaque);
+    rasterizer->texture(&texture);
+    const Vertex near_left(-1.5, -1.0, 0.2, 1.0, 0.0, 4.0, 0xffffffff);
+    const Vertex near_right(1.5, -1.0, 0.2, 1.0, 4.0, 4.0, 0xffffffff);
+    const Vertex far_left(-6.0, 0.5, 7.8, 8.0, 0.0, 0.0, 0xffffffff);
+    const Vertex far_right(6.0, 0.5, 7.8, 8.0, 4.0, 0.0, 0xff8080ff);
+    add(rasterizer, near_left, near_right, far_right, true);
+    add(rasterizer, near_left, far_right, far_left, true);
+    rasterizer->texture(0);
+}
+
+// two triangles through each other, then one behind which is not drawn
+// and one in front which does not write the depth
+void draw_depth(Rasterizer* rasterizer, const Image&)
+{
+    rasterizer->blend_mode(Rasterizer::BlendOpaque);
+    add(rasterizer,
+        Vertex(-0.9, -0.7, 0.1, 1.0, 0.0, 0.0, 0xffff4040),
+        Vertex(0.9, -0.5, 0.9, 1.0, 0.0, 0.0, 0xffff4040),
+        Vertex(0.0, 0.9, 0.5, 1.0, 0.0, 0.0, 0xffff4040),
+        false);
+    add(rasterizer,
+        Vertex(-0.9, -0.4, 0.9, 1.0, 0.0, 0.0, 0xff40ff40),
+        Vertex(0.9, -0.8, 0.1, 1.0, 0.0, 0.0, 0xff40ff40),
+        Vertex(0.2, 0.8, 0.5, 1.0, 0.0, 0.0, 0xff40ff40),
+        false);
+    add(rasterizer,
+        Vertex(-0.5, -0.9, 0.95, 1.0, 0.0, 0.0, 0xff4040ff),
+        Vertex(0.5, -0.9, 0.95, 1.0, 0.0, 0.0, 0xff4040ff),
+        Vertex(0.0, 0.5, 0.95, 1.0, 0.0, 0.0, 0xff4040ff),
+        false);
+    rasterizer->enable_depth_write(false);
+    add(rasterizer,
+        Vertex(-0.3, 0.1, 0.05, 1.0, 0.0, 0.0, 0xffffffff),
+        Vertex(0.3, 0.1, 0.05, 1.0, 0.0, 0.0, 0xffffffff),
+        Vertex(0.0, 0.7, 0.05, 1.0, 0.0, 0.0, 0xffffffff),
+        false);
+    add(rasterizer,
+        Vertex(-0.2, 0.0, 0.07, 1.0, 0.0, 0.0, 0xffffff00),
+        Vertex(0.2, 0.0, 0.07, 1.0, 0.0, 0.0, 0xffffff00),
+        Vertex(0.0, 0.4, 0.07, 1.0, 0.0, 0.0, 0xffffff00),
+        false);
+    rasterizer->enable_depth_write(true);
+}
+
+// the alpha of the vertexes over an opaque one, linear and additive
+void draw_blended(Rasterizer* rasterizer, const Image&)
+{
+    rasterizer->blend_mode(Rasterizer::BlendOpaque);
+    add(rasterizer,
+        Vertex(-1.0, -1.0, 0.9, 1.0, 0.0, 0.0, 0xff808080),
+        Vertex(1.0, -1.0, 0.9, 1.0, 0.0, 0.0, 0xff808080),
+        Vertex(0.0, 1.0, 0.9, 1.0, 0.0, 0.0, 0xff808080),
+        false);
+    rasterizer->enable_depth_write(false);
+    rasterizer->blend_mode(Rasterizer::BlendLinear);
+    add(rasterizer,
+        Vertex(-0.9, 0.9, 0.5, 1.0, 0.0, 0.0, 0x00ff0000),
+        Vertex(0.3, 0.9, 0.5, 1.0, 0.0, 0.0, 0xffff0000),
+        Vertex(-0.3, -0.7, 0.5, 1.0, 0.0, 0.0, 0x80ff0000),
+        false);
+    rasterizer->blend_mode(Rasterizer::BlendAdditive);
+    add(rasterizer,
+        Vertex(-0.2, -0.9, 0.5, 1.0, 0.0, 0.0, 0xff0000ff),
+        Vertex(0.9, -0.9, 0.5, 1.0, 0.0, 0.0, 0x400000ff),
+        Vertex(0.5, 0.6, 0.5, 1.0, 0.0, 0.0, 0xff00ff00),
+        false);
+    rasterizer->enable_depth_write(true);
+}
+
+// vertexes behind the eye, the clipped ones make a quad
+void draw_clipped(Rasterizer* rasterizer, const Image& texture)
+{
+    rasterizer->blend_mode(Rasterizer::BlendOpaque);
+    rasterizer->texture(&texture);
+    add(rasterizer,
+        Vertex(-0.5, -0.5, 0.5, 1.0, 0.0, 0.0, 0xffffffff),
+        Vertex(0.5, -0.5, 0.5, 1.0, 1.0, 0.0, 0xffffffff),
+        Vertex(0.0, 1.0, -0.5, -0.5, 0.5, 2.0, 0xffffffff),
+        true);
+    rasterizer->texture(0);
+    add(rasterizer,
+        Vertex(-0.9, 0.9, -0.2, -0.2, 0.0, 0.0, 0xff00ff00),
+        Vertex(-0.9, -0.9, -0.2, -0.2, 0.0, 0.0, 0xff00ff00),
+        Vertex(-0.6, 0.0, -0.1, -0.1, 0.0, 0.0, 0xff00ff00),
+        false);
+}
+
+class Scene
+{
+public:
+    const char* name;
+    void (*draw)(Rasterizer*, const Image&);
+};
+
+const Scene Scenes[] =
+{
+    { "shaded", draw_shaded },
+    { "textured", draw_textured },
+    { "depth", draw_depth },
+    { "blended", draw_blended },
+    { "clipped", draw_clipped },
+};
+const int SceneSize = sizeof(Scenes) / sizeof(Scenes[0]);
+
+// false when it differs from the reference, which is then saved beside
+bool test(  const Scene& scene,
+            const Image& texture,
+            const std::string& directory,
+            bool does_update)
+{
+    const std::string reference_name
+    = directory + "/test/reference/" + scene.name + ".tga";
+    Image reference;
+
+    if (!does_update && !Image::load(reference_name, &reference))
+    {
+        std::printf(    "%-9s cannot load %s: FAILED\n",
+                        scene.name,
+                        reference_name.c_str());
+        return false;
+    }
+
+    bool is_ok = true;
+
+    for (int i = 0; i < ThreadCountSize; ++i)
+    {
+        Rasterizer rasterizer(Width, Height, ThreadCounts[i]);
+        rasterizer.clear(Background);
+        scene.draw(&rasterizer, texture);
+        rasterizer.flush();
+        const Image& frame = *rasterizer.frame();
+
+        if (does_update)
+        {
+            frame.save(reference_name);
+            std::printf("%-9s saved %s\n", scene.name, reference_name.c_str());
+            return true;
+        }
+
+        const int differences = frame.count_differences(reference, Tolerance);
+        std::printf(    "%-9s %d threads, %d pixels differ: %s\n",
+                        scene.name,
+                        ThreadCounts[i],
+                        differences,
+                        differences == 0 ? "ok" : "FAILED");
+
+        if (differences > 0)
+        {
+            frame.save(std::string(scene.name) + ".tga");
+            is_ok = false;
+        }
+    }
+
+    return is_ok;
+}
+
+} // namespace -
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: rasterizer_test <c18 dir> [--update]\n");
+        return 1;
+    }
+
+    const std::string directory = argv[1];
+    const bool does_update = argc > 2 && std::strcmp(argv[2], "--update") == 0;
+    Image texture;
+
+    if (!Image::load(directory + "/data/image/grid.tga", &texture))
+    {
+        std::printf("cannot load the texture: FAILED\n");
+        return 1;
+    }
+
+    bool is_ok = true;
+
+    for (int i = 0; i < SceneSize; ++i)
+    {
+        is_ok = test(Scenes[i], texture, directory, does_update) && is_ok;
+    }
+
+    return is_ok ? 0 : 1;
+}